@@ -14,6 +14,12 @@
 /** Macro to disable all interrupts. */
 #define DisableInterrupts asm(" CPSID i");
 
+/** Macro to save PRIMASK in a uint32_t and disable all interrupts. Nests. */
+#define DisableInterruptsSave(primask)  __asm volatile ("MRS %0, primask\n CPSID i" : "=r" (primask) :: "memory")
+
+/** Macro to restore the PRIMASK saved by DisableInterruptsSave(). */
+#define RestoreInterrupts(primask)      __asm volatile ("MSR primask, %0" :: "r" (primask) : "memory")
+
 
 /***************************** Configuracin de tipos de datos *****************************/
 
@@ -0,0 +1,113 @@
+/*
+ * =============================================================================
+ * File Name    : BAM.h
+ * Project      : S32K144_basic
+ * Module       : Bit Angle Modulation Module (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Multi-channel software PWM based on Bit Angle Modulation. The duty of
+ *   every channel is split in BAM_BITS bit planes, and the plane k is shown
+ *   during a slot of BAM_BASE_TICKS << k timer ticks. Set/clear/toggle words
+ *   are precomputed per port, so one LPIT interrupt updates every channel of a
+ *   port with a single store per slot (PTOR), plus a resynchronization with
+ *   PSOR/PCOR at the start of each frame. The CPU cost only depends on the
+ *   number of ports in use, not on the number of channels (up to 32 per port).
+ *
+ * Dependencies :
+ *   - GPIO driver
+ *   - LPIT driver (channel LPIT_CH_BAM)
+ *
+ * Configuration :
+ *   - BAM_BITS: resolution of the duty (8 bits, 0..255)
+ *   - BAM_BASE_TICKS: length of the shortest slot, frame = 255 slots
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+#ifndef BAM_H_
+#define BAM_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define BAM_BITS                       8U
+#define BAM_MAX_CH                     32U
+#define BAM_DUTY_MAX                   ((1U << BAM_BITS) - 1U)
+
+/* Shortest slot: 20 us, frame of 255 slots = 5.1 ms (196 Hz) */
+#define BAM_BASE_TICKS                 LPIT_US_TO_TICKS(20U)
+
+#define BAM_INVALID_CH                 0xFFU
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Add a pin to the engine
+ * @param: ptx_n: output pin, configured as GPIO output
+ * @param: active_low: true if the load is on with a low level
+ * @return: channel number, BAM_INVALID_CH if the table is full
+ * @note: The channel starts with duty 0 (off)
+ */
+uint8_t BAM_Attach(PTXn_e ptx_n, bool active_low);
+
+/*
+ * @brief: Set the duty of a channel
+ * @param: ch: channel returned by BAM_Attach()
+ * @param: duty: 0 (off) .. BAM_DUTY_MAX (on)
+ * @note: The new value is applied at the start of the next frame
+ */
+void BAM_SetDuty(uint8_t ch, uint8_t duty);
+
+/*
+ * @brief: Get the duty of a channel
+ * @param: ch: channel returned by BAM_Attach()
+ * @return: duty set with BAM_SetDuty()
+ */
+uint8_t BAM_GetDuty(uint8_t ch);
+
+/*
+ * @brief: Start the slot timer
+ */
+void BAM_Start(void);
+
+/*
+ * @brief: Stop the slot timer, the outputs keep their last level
+ */
+void BAM_Stop(void);
+
+/*
+ * @brief: BAM Test Routine, breathing effect on the LEDs of led_table
+ */
+void Test_BAM(void);
+
+#endif /* BAM_H_ */
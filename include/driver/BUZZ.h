@@ -10,14 +10,15 @@
  * Description  :
  *   This file contains functions for controlling a buzzer to play simple songs.
  *   In this example, the buzzer will play a song in a predefined pattern.
+ *   Tones are generated by FTM0 in PWM mode, so a note plays in hardware and
+ *   BUZZ_Tone() returns at once.
  *
  * Dependencies :
- *   - GPIO driver for buzzer control
- *   - Timer driver for generating delays
+ *   - FTM driver for the tone (FTM0 ch1, the buzzer owns FTM0)
+ *   - LPIT software tick for the note duration
  *
  * Configuration :
- *   - Buzzer connected to GPIO pin PTD16
- *   - Timer configured for delay generation
+ *   - Buzzer connected to PTD16 (FTM0_CH1)
  *
  * License :
  *   This file is part of a free software project released under the terms of
@@ -45,53 +46,88 @@
 //==============================================================================
 //                         PUBLIC DEFINES AND MACROS
 //==============================================================================
-#define BUZZ_OFF()                     GPIO_PinWrite(PTD16, 0);
-#define BUZZ_ON()                      GPIO_PinWrite(PTD16, 1);
+#define BUZZ_PIN                       PTD16   // FTM0_CH1 (ALT2)
+#define BUZZ_FTM                       0U
+#define BUZZ_QUEUE_LEN                 16U     // Notes given with BUZZ_Queue()
+#define BUZZ_ENV_LEN                   256U    // Envelope steps of 1 ms (LPIT tick)
 #define LED                            PTB12
 
-/* Song */
-#define D0                             0xFFFFU
-#define D1                             262
-#define D2                             293
-#define D3                             329
-#define D4                             349
-#define D5                             392
-#define D6                             440
-#define D7                             494
-
-#define M1                             523
-#define M2                             586
-#define M3                             658
-#define M4                             697
-#define M5                             783
-#define M6                             879
-#define M7                             987
-
-#define H1                             1045
-#define H2                             1171
-#define H3                             1316
-#define H4                             1393
-#define H5                             1563
-#define H6                             1755
-#define H7                             1971
-
-/* List all D frequencies */
-#define WHOLE                          1
-#define HALF                           0.5
-#define QUARTER                        0.25
-#define EIGHTH                         0.25
-#define SIXTEENTH                      0.625
+/* Tempo of the songs, a note lasts a number of ticks of BUZZ_TICK_MS */
+#define BUZZ_TEMPO_BPM                 120U
+#define BUZZ_TICKS_PER_BEAT            16U
+#define BUZZ_TICK_MS                   ((60000U + (BUZZ_TEMPO_BPM * BUZZ_TICKS_PER_BEAT) / 2U) / \
+                                        (BUZZ_TEMPO_BPM * BUZZ_TICKS_PER_BEAT))
+
+/* Packed note: bits 15..10 note (0: rest), bits 9..0 duration in ticks */
+#define BUZZ_NOTE(note, ticks)         ((buzz_note)(((uint16_t)(note) << 10) | ((uint16_t)(ticks) & 0x3FFU)))
+#define BUZZ_NOTE_INDEX(n)             ((uint8_t)((n) >> 10))
+#define BUZZ_NOTE_TICKS(n)             ((uint16_t)((n) & 0x3FFU))
+#define BUZZ_END                       ((buzz_note)0U)     // Last word of a song
+
+/* Note index of a MIDI note, C3 (48) .. D8 (110) */
+#define BUZZ_MIDI_MIN                  48U
+#define BUZZ_MIDI_MAX                  110U
+#define BUZZ_MIDI(m)                   ((uint8_t)((m) - (BUZZ_MIDI_MIN - 1U)))
+
+/* Song, simple notation: D = 4th octave, M = 5th, H = 6th */
+#define D0                             0U      // Rest
+#define D1                             BUZZ_MIDI(60U)
+#define D2                             BUZZ_MIDI(62U)
+#define D3                             BUZZ_MIDI(64U)
+#define D4                             BUZZ_MIDI(65U)
+#define D5                             BUZZ_MIDI(67U)
+#define D6                             BUZZ_MIDI(69U)
+#define D7                             BUZZ_MIDI(71U)
+
+#define M1                             BUZZ_MIDI(72U)
+#define M2                             BUZZ_MIDI(74U)
+#define M3                             BUZZ_MIDI(76U)
+#define M4                             BUZZ_MIDI(77U)
+#define M5                             BUZZ_MIDI(79U)
+#define M6                             BUZZ_MIDI(81U)
+#define M7                             BUZZ_MIDI(83U)
+
+#define H1                             BUZZ_MIDI(84U)
+#define H2                             BUZZ_MIDI(86U)
+#define H3                             BUZZ_MIDI(88U)
+#define H4                             BUZZ_MIDI(89U)
+#define H5                             BUZZ_MIDI(91U)
+#define H6                             BUZZ_MIDI(93U)
+#define H7                             BUZZ_MIDI(95U)
+
+/* Durations in ticks, WHOLE is one beat */
+#define WHOLE                          BUZZ_TICKS_PER_BEAT
+#define HALF                           (BUZZ_TICKS_PER_BEAT / 2U)
+#define QUARTER                        (BUZZ_TICKS_PER_BEAT / 4U)
+#define EIGHTH                         (BUZZ_TICKS_PER_BEAT / 8U)
+#define SIXTEENTH                      (BUZZ_TICKS_PER_BEAT / 16U)
 
 
 //==============================================================================
 //                        PUBLIC TYPES AND ENUMERATIONS
 //==============================================================================
+/* Packed note, see BUZZ_NOTE() */
+typedef uint16_t buzz_note;
+
+/* Called when a note starts (from the timer interrupt, except the first one) */
+typedef void (*buzz_note_hook)(buzz_note note, void *ctx);
+
+/* Called from the timer interrupt when the last note ends */
+typedef void (*buzz_done_callback)(void *ctx);
+
+/* Duty envelope of the tones, times in ms and sustain level of 255 */
+typedef struct {
+    uint16_t attack_ms;
+    uint16_t decay_ms;
+    uint8_t sustain;
+    uint16_t release_ms;
+} buzz_adsr;
 
 //==============================================================================
 //                         PUBLIC GLOBAL VARIABLES
 //==============================================================================
-extern const uint16_t tune[];
-extern const float durt[];
+extern const buzz_note song[];
+extern const buzz_adsr buzz_soft;
 
 //==============================================================================
 //                        PUBLIC FUNCTION DECLARATIONS
@@ -104,14 +140,82 @@ void BUZZ_Init(void);
 
 /*
  * @brief Main task to perform the buzzer activities
+ * @note: Starts the song (with LED3 flashing on every note) when the buzzer
+ *        is idle, returns at once
  */
 void BUZZ_MainTask(void);
 
 /*
  * @brief: Play a note with the buzzer
  * @param: note: musical note from 'A' to 'H'
- * @param: duration: duration time in us
+ * @param: duration: duration time in ms
+ * @note: Returns at once, see BUZZ_Tone()
  */
 void BUZZ_playNote(char note, uint16_t duration);
 
+/*
+ * @brief: Play a tone in hardware
+ * @param: freq_hz: frequency, 0 for silence
+ * @param: duration_ms: time until the buzzer stops, 0 to play until
+ *         BUZZ_NoTone()
+ * @note: Returns at once, a new tone replaces the one playing. With an
+ *        envelope the tone stays at the sustain level when duration_ms is 0
+ */
+void BUZZ_Tone(uint16_t freq_hz, uint16_t duration_ms);
+
+/*
+ * @brief: Stop the tone, the output stays low
+ */
+void BUZZ_NoTone(void);
+
+/*
+ * @brief: Play a song in the background
+ * @param: notes: packed notes ending with BUZZ_END, must stay valid while
+ *         playing
+ * @param: done: called when the song and the queue are over (NULL: none)
+ * @param: ctx: user pointer passed back to done
+ * @note: Stops what is playing, the queued notes are dropped
+ */
+void BUZZ_Play(const buzz_note *notes, buzz_done_callback done, void *ctx);
+
+/*
+ * @brief: Add a note to the queue, played after the song (if any)
+ * @param: note: packed note
+ * @return: false if the queue is full (or the note is BUZZ_END)
+ */
+bool BUZZ_Queue(buzz_note note);
+
+/*
+ * @brief: Stop the song and drop the queue, done is not called
+ */
+void BUZZ_Stop(void);
+
+/*
+ * @brief: Check if the sequencer is playing
+ * @return: true until the last note has ended
+ */
+bool BUZZ_IsBusy(void);
+
+/*
+ * @brief: Set the function called when a note starts
+ * @param: hook: function called from the timer interrupt (NULL: none)
+ * @param: ctx: user pointer passed back to the hook
+ */
+void BUZZ_SetNoteHook(buzz_note_hook hook, void *ctx);
+
+/*
+ * @brief: Set the duty envelope of the next tones and notes
+ * @param: adsr: envelope, NULL for a flat duty. Attack plus decay and release
+ *         are limited to BUZZ_ENV_LEN ms
+ * @note: The duty is stepped every 1 ms by DMA_CH_BUZZ_ENV, the CPU only sets
+ *        up the steps when a note starts
+ */
+void BUZZ_SetEnvelope(const buzz_adsr *adsr);
+
+/*
+ * @brief: Set the volume of the next tones and notes
+ * @param: volume: 0..255, 255 is 50% duty (loudest)
+ */
+void BUZZ_SetVolume(uint8_t volume);
+
 #endif /* DRIVER_BUZZ_H_ */
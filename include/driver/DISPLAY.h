@@ -0,0 +1,145 @@
+/*
+ * =============================================================================
+ * File Name    : DISPLAY.h
+ * Project      : S32K144_basic
+ * Module       : Multiplexed Display Module (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Refresh engine for multiplexed LED matrices and 7-segment banks. The rows
+ *   (matrix rows or digit commons) are lit one at a time and the eDMA writes
+ *   precomputed words to the PCOR/PSOR registers of the port, paced by FTM2,
+ *   so the refresh needs no CPU time. The on-time of every row is set by a
+ *   second FTM2 compare that blanks the row, which gives a brightness per row.
+ *
+ *   The application writes a frame buffer (one word of segment bits per row)
+ *   and calls DISPLAY_Show(). The words are built into the buffer that is not
+ *   being displayed and the DMA switches at the end of a frame, so a frame is
+ *   never shown half updated.
+ *
+ * Dependencies :
+ *   - FTM driver (FTM2 ch0/ch1 as DMA triggers, no pins)
+ *   - DMA driver, three channels
+ *
+ * Configuration :
+ *   - DISPLAY_ROW_US: time of one row, refresh = 1 / (nrows * DISPLAY_ROW_US)
+ *   - All rows and segments must be on the same port
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+#ifndef DRIVER_DISPLAY_H_
+#define DRIVER_DISPLAY_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define DISPLAY_MAX_ROWS               8U
+#define DISPLAY_MAX_SEGS               16U
+#define DISPLAY_FTM                    2U
+#define DISPLAY_ROW_US                 250U    // 8 rows: 500 Hz refresh
+#define DISPLAY_BLANK_US               2U      // Minimum dark time between rows
+
+/* 7-segment bits, segments given in this order in display_cfg */
+#define DISPLAY_SEG_A                  0x01U
+#define DISPLAY_SEG_B                  0x02U
+#define DISPLAY_SEG_C                  0x04U
+#define DISPLAY_SEG_D                  0x08U
+#define DISPLAY_SEG_E                  0x10U
+#define DISPLAY_SEG_F                  0x20U
+#define DISPLAY_SEG_G                  0x40U
+#define DISPLAY_SEG_DP                 0x80U
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+typedef struct {
+    PTXn_e rows[DISPLAY_MAX_ROWS];      // Lit one at a time
+    uint8_t nrows;
+    PTXn_e segs[DISPLAY_MAX_SEGS];      // Bit n of a row word drives segs[n]
+    uint8_t nsegs;
+    bool rows_low;                      // Rows active low (common anode, PNP)
+    bool segs_low;                      // Segments active low
+} display_cfg;
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+/* 7-segment codes of 0..9, A..F */
+extern const uint8_t display_hex[16];
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Configure the display pins, all rows off
+ * @param: cfg: rows and segments of the display
+ * @return: false if the display is too big or the pins are not on one port
+ */
+bool DISPLAY_Init(const display_cfg *cfg);
+
+/*
+ * @brief: Start the refresh
+ */
+void DISPLAY_Start(void);
+
+/*
+ * @brief: Stop the refresh, all rows off
+ */
+void DISPLAY_Stop(void);
+
+/*
+ * @brief: Set the segments of a row in the frame buffer
+ * @param: row: row index
+ * @param: segs: bit n lights segs[n]
+ */
+void DISPLAY_SetRow(uint8_t row, uint16_t segs);
+
+/*
+ * @brief: Clear the frame buffer
+ */
+void DISPLAY_Clear(void);
+
+/*
+ * @brief: Show the frame buffer from the next frame on
+ * @note: Waits (at most two frames) if the previous frame given to
+ *        DISPLAY_Show() has not been displayed yet
+ */
+void DISPLAY_Show(void);
+
+/*
+ * @brief: Set the on-time of a row
+ * @param: row: row index, DISPLAY_MAX_ROWS for all rows
+ * @param: level: 1..255 (full on-time), 0 keeps the row dark
+ * @note: The on-time changes at once, a change to or from 0 from the next
+ *        DISPLAY_Show()
+ */
+void DISPLAY_SetBrightness(uint8_t row, uint8_t level);
+
+/*
+ * @brief: Test Routine, counter on a 4 digit 7-segment display on PTE
+ */
+void Test_DISPLAY(void);
+
+#endif /* DRIVER_DISPLAY_H_ */
@@ -50,6 +50,32 @@
 //==============================================================================
 //                         PUBLIC DEFINES AND MACROS
 //==============================================================================
+/* Debounce, keys are sampled every KEY_TICK_MS from the LPIT software tick */
+#define KEY_TICK_MS                    1U
+#define KEY_PRESS_MS                   10U     // Time pressed to report a press
+#define KEY_RELEASE_MS                 20U     // Time released to report a release
+
+/* Port debouncer, one vertical counter per port sampled every KEY_PORT_TICK_MS */
+#define KEY_PORT_NUM                   5U      // PTA..PTE
+#define KEY_PORT_TICK_MS               5U      // 4 samples, 20 ms debounce
+
+/* Interrupt wake mode, level confirmed by a LPTMR one-shot after the first edge */
+#define KEY_CONFIRM_MS                 20U
+
+/* Gesture engine and event queue */
+#define KEY_GESTURE_TICK_MS            10U     // Resolution of long press and repeat
+#define KEY_GESTURE_SLOTS              8U      // Keys tracked at the same time
+#define KEY_EVENT_QUEUE                32U     // Pending events, power of 2
+#define KEY_LONG_MS                    800U
+#define KEY_DOUBLE_MS                  300U
+#define KEY_REPEAT_MS                  100U    // 0: no auto-repeat after a long press
+
+/* Event codes: board keys use their Key_types value */
+#define KEY_CODE_PIN(ptx_n)            (0x100U + (uint16_t)(ptx_n))   // Port debouncer pins
+#define KEY_CODE_MATRIX(n)             (0x200U + (uint16_t)(n))       // Keypad, row * 8 + col
+
+/* Bit of a key in the state and edge masks */
+#define KEY_MASK(key)                  (1UL << (key))
 
 //==============================================================================
 //                        PUBLIC TYPES AND ENUMERATIONS
@@ -75,6 +101,37 @@ typedef enum {
     KSTATUS_B3_PRESS,
 } KeyStatus_types;
 
+/* Events reported by the gesture engine */
+typedef enum {
+    KEY_EV_PRESS,
+    KEY_EV_RELEASE,
+    KEY_EV_LONG,                        // Held for long_ms
+    KEY_EV_REPEAT,                      // Held after the long press, every repeat_ms
+    KEY_EV_DOUBLE,                      // Pressed again within double_ms (count = clicks)
+} key_event_type;
+
+typedef struct {
+    uint32_t time;                      // LPIT software tick (ms) of the event
+    uint16_t code;                      // Key_types value or KEY_CODE_PIN(pin)
+    uint8_t type;                       // key_event_type
+    uint8_t count;                      // Clicks (DOUBLE) or repeats (REPEAT)
+} key_event;
+
+/* Gesture timings in milliseconds */
+typedef struct {
+    uint16_t long_ms;
+    uint16_t double_ms;
+    uint16_t repeat_ms;
+} key_gesture_cfg;
+
+/* Debounced state of a port, bit n belongs to pin n */
+typedef struct {
+    uint32_t state;                     // Pins pressed now
+    uint32_t pressed;                   // Pressed since the last read
+    uint32_t released;                  // Released since the last read
+    uint32_t changed;                   // Pressed or released since the last read
+} key_port_status;
+
 //==============================================================================
 //                         PUBLIC GLOBAL VARIABLES
 //==============================================================================
@@ -88,23 +145,110 @@ typedef enum {
  */
 void KEY_Init(void);
 
+/*
+ * @brief: KEY Initialization in interrupt wake mode
+ * @note: No periodic sampling: the first edge of a key masks its interrupt and
+ *        arms a KEY_CONFIRM_MS one-shot on LPTMR0, which reads the level,
+ *        posts the event and unmasks the pin. Every key waits its own
+ *        KEY_CONFIRM_MS, the one-shot is re-armed for the latest one. The core
+ *        can sleep between presses. PORTD_IRQn must be enabled by the caller.
+ */
+void KEY_WakeInit(void);
+
 /*
  * @brief: Get key value
  * @param: mode: MODE_NOCONT, does not support continuous pressing; MODE_CONT,
  *               supports continuous pressing.
+ * @note: Non-blocking, returns the state debounced by the software tick
  * @return: KeyStatus_types, KSTATUS_NOPRESS: No button pressed KSTATUS_B1_PRESS:
  *          Button 1 pressed KSTATUS_B2_PRESS: Button 2 pressed KSTATUS_B3_PRESS:
  *          Button 3 pressed
  */
 KeyStatus_types KEY_Read(Mode_types mode, Key_types key);
 
+/*
+ * @brief: Change the debounce times
+ * @param: press_ms: time the key must read pressed to report a press
+ * @param: release_ms: time the key must read released to report a release
+ */
+void KEY_SetDebounce(uint16_t press_ms, uint16_t release_ms);
+
+/*
+ * @brief: Get the debounced state of all the keys
+ * @return: mask of KEY_MASK(key) bits, set while the key is pressed
+ */
+uint32_t KEY_GetState(void);
+
+/*
+ * @brief: Get and clear the press edges
+ * @return: mask of KEY_MASK(key) bits pressed since the last call
+ */
+uint32_t KEY_GetPressed(void);
+
+/*
+ * @brief: Get and clear the release edges
+ * @return: mask of KEY_MASK(key) bits released since the last call
+ */
+uint32_t KEY_GetReleased(void);
+
+/*
+ * @brief: Debounce an active low input with the port debouncer
+ * @param: ptx_n: pin, configured as input with pull-up
+ * @note: Any number of pins of any port, the cost per tick is a few word
+ *        operations per port
+ */
+void KEY_PortAdd(PTXn_e ptx_n);
+
+/*
+ * @brief: Stop debouncing a pin
+ * @param: ptx_n: pin given to KEY_PortAdd()
+ */
+void KEY_PortRemove(PTXn_e ptx_n);
+
+/*
+ * @brief: Get the debounced state of a port and clear its edges
+ * @param: port: port index, PTX(pin) (0 = PTA .. 4 = PTE)
+ * @param: status: returns the state and the edges since the last call
+ */
+void KEY_PortRead(uint8_t port, key_port_status *status);
+
+/*
+ * @brief: Change the gesture timings
+ * @param: cfg: new timings, used from the next event
+ */
+void KEY_GestureConfig(const key_gesture_cfg *cfg);
+
+/*
+ * @brief: Report a debounced key edge to the gesture engine
+ * @param: code: key identifier (not 0)
+ * @param: pressed: true for a press, false for a release
+ * @note: Board keys and port debouncer pins are fed automatically. Safe from
+ *        any interrupt, the slots and the queue are updated with the
+ *        interrupts disabled.
+ */
+void KEY_EventFeed(uint16_t code, bool pressed);
+
+/*
+ * @brief: Take the pending events from the queue
+ * @param: events: buffer for the events, oldest first
+ * @param: max: size of the buffer
+ * @return: number of events copied
+ */
+uint8_t KEY_EventGet(key_event *events, uint8_t max);
+
+/*
+ * @brief: Get the number of events dropped because the queue was full
+ * @return: dropped events
+ */
+uint32_t KEY_EventGetLost(void);
+
 /*
  * @brief: Key Test Procedure
  */
 void Test_KEY(void);
 
 /*
- * @brief: Key Test with interrupt
+ * @brief: Key Test with interrupt wake mode
  */
 void Test_KEYint(void);
 
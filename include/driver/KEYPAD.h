@@ -0,0 +1,113 @@
+/*
+ * =============================================================================
+ * File Name    : KEYPAD.h
+ * Project      : S32K144_basic
+ * Module       : Matrix Keypad Module (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Scanner for matrix keypads up to 8x8 keys. Every scan drives one row at a
+ *   time and reads all the columns with a single PDIR read. The whole matrix
+ *   is debounced in parallel and the edges are reported to the KEY event
+ *   queue, so keypad keys get the same gestures as the board keys.
+ *
+ * Dependencies :
+ *   - GPIO driver
+ *   - KEY module (event queue)
+ *   - LPIT driver (software tick)
+ *
+ * Configuration :
+ *   - Rows on one port, columns on one port (can be the same one)
+ *   - Columns use the internal pull-ups, keys connect a row to a column
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+#ifndef DRIVER_KEYPAD_H_
+#define DRIVER_KEYPAD_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define KEYPAD_MAX_ROWS                8U
+#define KEYPAD_MAX_COLS                8U
+#define KEYPAD_TICK_MS                 5U      // Full matrix scan period
+#define KEYPAD_SETTLE_US               3U      // Column settle time after a row change
+
+/* Bit of a key in the state mask */
+#define KEYPAD_BIT(row, col)           (1ULL << ((row) * KEYPAD_MAX_COLS + (col)))
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+typedef struct {
+    PTXn_e rows[KEYPAD_MAX_ROWS];       // Driven low one at a time
+    uint8_t nrows;
+    PTXn_e cols[KEYPAD_MAX_COLS];       // Inputs with pull-up
+    uint8_t ncols;
+} keypad_cfg;
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Configure the keypad pins
+ * @param: cfg: rows and columns of the matrix
+ * @return: false if the matrix is too big or the rows (or columns) are not on
+ *          the same port
+ */
+bool KEYPAD_Init(const keypad_cfg *cfg);
+
+/*
+ * @brief: Start scanning from the software tick
+ */
+void KEYPAD_Start(void);
+
+/*
+ * @brief: Stop scanning, all rows released
+ */
+void KEYPAD_Stop(void);
+
+/*
+ * @brief: Get the debounced state of the matrix
+ * @return: mask of KEYPAD_BIT(row, col) bits, set while the key is pressed
+ */
+uint64_t KEYPAD_GetState(void);
+
+/*
+ * @brief: Get the number of scans where ghosting was detected
+ * @return: ghosted scans since KEYPAD_Init()
+ */
+uint32_t KEYPAD_GetGhosts(void);
+
+/*
+ * @brief: Keypad Test Procedure, prints the pressed keys of a 4x4 keypad
+ */
+void Test_KEYPAD(void);
+
+#endif /* DRIVER_KEYPAD_H_ */
@@ -14,8 +14,8 @@
  *   state.
  *
  *   LED pin mappings:
- *     - LED1_IO : PTC17 (Core board)
- *     - LED2_IO : PTD17
+ *     - LED1_IO : PTC17 (Core board, active-low)
+ *     - LED2_IO : PTD17 (active-low)
  *     - LED3_IO : PTA11
  *     - LED4_IO : PTA12
  *     - LED5_IO : PTA13
@@ -25,7 +25,7 @@
  *   - GPIO driver
  *
  * Configuration :
- *   - Output mode, active-high logic
+ *   - Output mode, polarity of each LED in the descriptor table of LED.c
  *
  * License :
  *   This file is part of a free software project released under the terms of
@@ -61,7 +61,12 @@
 #define LED5_IO             PTA13
 #define LED6_IO             PTA14
 
-#define MAX_LED             6U
+#define MAX_LED             6U      // Entries of the descriptor table (up to 32)
+
+/* Bit of a LED in the masks of LED_SetMask() */
+#define LED_MASK(led)       (1UL << ((led) - 1U))
+
+#define LED_NO_PIN          ((PTXn_e)0xFFU)  // LED_GetPin() of a LED not in the table
 
 //==============================================================================
 //                         PUBLIC GLOBAL VARIABLES
@@ -94,6 +99,44 @@ void LED_OFF(uint8_t led);
  */
 void LED_Reverse(uint8_t led);
 
+/*
+ * @brief: Set the state of every LED at once
+ * @param: on_mask: LED_MASK(led) bits of the LEDs to turn on, the others are
+ *         turned off
+ * @note: At most one PSOR and one PCOR store per port, whatever the number
+ *        of LEDs
+ */
+void LED_SetMask(uint32_t on_mask);
+
+/*
+ * @brief: Set the state of a group of LEDs at once
+ * @param: on_mask: LED_MASK(led) bits of the LEDs to turn on
+ * @param: sel_mask: LED_MASK(led) bits of the LEDs to update, the other LEDs
+ *         are not changed
+ */
+void LED_UpdateMask(uint32_t on_mask, uint32_t sel_mask);
+
+/*
+ * @brief: Get the state of every LED
+ * @return: LED_MASK(led) bits of the LEDs that are on
+ */
+uint32_t LED_GetMask(void);
+
+/*
+ * @brief: Get the pin of a LED
+ * @param: led: number of LED
+ * @return: pin from the descriptor table, LED_NO_PIN if led is not in it
+ */
+PTXn_e LED_GetPin(uint8_t led);
+
+/*
+ * @brief: Get the polarity of a LED
+ * @param: led: number of LED
+ * @return: true if the LED is on with the pin at 0, false if led is not
+ *          in the table
+ */
+bool LED_IsActiveLow(uint8_t led);
+
 /*
  * @brief: Test Routine LED
  */
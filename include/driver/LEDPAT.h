@@ -0,0 +1,133 @@
+/*
+ * =============================================================================
+ * File Name    : LEDPAT.h
+ * Project      : S32K144_basic
+ * Module       : LED Pattern Module (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Non-blocking LED pattern engine. A pattern is a short bytecode program
+ *   (on/off with a duration, fades, loops) stored in flash. One timer callback
+ *   advances every LED and writes all the on/off LEDs with one LED_UpdateMask()
+ *   call, so running patterns costs a few microseconds per tick. The callback
+ *   is only attached while a pattern runs.
+ *
+ *   Example, blink 3 times every second:
+ *     const uint8_t p[] = { LP_LOOP(0), LP_LOOP(3), LP_ON(LP_MS(100)),
+ *                           LP_OFF(LP_MS(100)), LP_NEXT, LP_OFF(LP_MS(400)),
+ *                           LP_NEXT, LP_END };
+ *
+ * Dependencies :
+ *   - LED module
+ *   - BAM module (LEDs with fades)
+ *   - LPIT driver (software tick)
+ *
+ * Configuration :
+ *   - LEDPAT_TICK_MS: time unit of the durations
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+#ifndef LEDPAT_H_
+#define LEDPAT_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define LEDPAT_TICK_MS                 10U
+#define LEDPAT_LOOP_DEPTH              2U      // Nested loops per pattern
+
+/* Opcodes */
+#define LP_OP_END                      0U      // Stop, the LED keeps its level
+#define LP_OP_ON                       1U      // ticks
+#define LP_OP_OFF                      2U      // ticks
+#define LP_OP_FADE                     3U      // level, ticks
+#define LP_OP_LOOP                     4U      // count (0 = forever)
+#define LP_OP_NEXT                     5U      // End of the loop body
+
+/* Bytecode, durations in LEDPAT_TICK_MS ticks (1..255) */
+#define LP_END                         LP_OP_END
+#define LP_ON(t)                       LP_OP_ON, (uint8_t)(t)
+#define LP_OFF(t)                      LP_OP_OFF, (uint8_t)(t)
+#define LP_FADE(level, t)              LP_OP_FADE, (uint8_t)(level), (uint8_t)(t)
+#define LP_LOOP(n)                     LP_OP_LOOP, (uint8_t)(n)
+#define LP_NEXT                        LP_OP_NEXT
+
+/* Conversion from milliseconds to ticks */
+#define LP_MS(ms)                      ((ms) / LEDPAT_TICK_MS)
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+/* Ready to use patterns */
+extern const uint8_t ledpat_flash[];
+extern const uint8_t ledpat_blink[];
+extern const uint8_t ledpat_heartbeat[];
+extern const uint8_t ledpat_sos[];
+extern const uint8_t ledpat_breathe[];
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Initialize the LEDs and the pattern engine
+ * @note: The software tick is attached by LEDPAT_Start(), and detached
+ *        again when no pattern runs
+ */
+void LEDPAT_Init(void);
+
+/*
+ * @brief: Run a pattern on a LED
+ * @param: led: number of LED
+ * @param: pattern: bytecode ending with LP_END, must stay valid while it runs
+ * @param: delay_ms: time before the first instruction, to shift sequences
+ * @return: false if the LED does not exist
+ * @note: A pattern with fades moves the LED to a BAM channel for good
+ */
+bool LEDPAT_Start(uint8_t led, const uint8_t *pattern, uint16_t delay_ms);
+
+/*
+ * @brief: Stop the pattern of a LED
+ * @param: led: number of LED
+ * @param: on: level left on the LED
+ */
+void LEDPAT_Stop(uint8_t led, bool on);
+
+/*
+ * @brief: Check if a LED runs a pattern
+ * @param: led: number of LED
+ * @return: false once the pattern reached LP_END or was stopped
+ */
+bool LEDPAT_IsRunning(uint8_t led);
+
+/*
+ * @brief: Test Routine, one pattern on every LED
+ */
+void Test_LEDPAT(void);
+
+#endif /* LEDPAT_H_ */
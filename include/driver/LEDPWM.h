@@ -0,0 +1,116 @@
+/*
+ * =============================================================================
+ * File Name    : LEDPWM.h
+ * Project      : S32K144_basic
+ * Module       : LED PWM Dimming Module (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Hardware PWM dimming for the LEDs whose pins can be routed to a FlexTimer
+ *   channel (LED3..LED5 on FTM1 ch5..ch7). Levels go through a gamma corrected
+ *   lookup table and fades are walked by the eDMA, paced by the PWM itself, so
+ *   a fade costs no CPU time after it has been started.
+ *
+ * Dependencies :
+ *   - FTM driver (FTM1, or FTM2: channels with their own DMA request)
+ *   - DMA driver, two channels per LED
+ *   - LED module (pin and polarity of each LED)
+ *
+ * Configuration :
+ *   - LEDPWM_PERIOD: PWM period in FTM ticks (1 kHz)
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+#ifndef LEDPWM_H_
+#define LEDPWM_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define LEDPWM_FTM                     1U
+#define LEDPWM_PERIOD                  8000U   // FTM_CLK_HZ / 8000 = 1 kHz
+#define LEDPWM_HZ                      (FTM_CLK_HZ / LEDPWM_PERIOD)
+#define LEDPWM_MAX                     3U      // LEDs with PWM at the same time
+#define LEDPWM_LEVEL_MAX               255U
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+/* Brightness curve of a fade */
+typedef enum {
+    LEDPWM_LINEAR,                      // Perceived brightness changes linearly (gamma 2.2)
+    LEDPWM_EXP,                         // Duty changes by a constant ratio per step
+} ledpwm_curve;
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Start the PWM counter
+ */
+void LEDPWM_Init(void);
+
+/*
+ * @brief: Move a LED to its PWM channel
+ * @param: led: number of LED
+ * @return: false if the pin has no FTM channel with DMA or no slot is free
+ * @note: After this, LED_ON()/LED_OFF() have no effect on the LED
+ */
+bool LEDPWM_Attach(uint8_t led);
+
+/*
+ * @brief: Set the level of a LED now
+ * @param: led: number of LED given to LEDPWM_Attach()
+ * @param: level: 0 (off) .. LEDPWM_LEVEL_MAX, gamma corrected
+ */
+void LEDPWM_Set(uint8_t led, uint8_t level);
+
+/*
+ * @brief: Fade a LED from its current level
+ * @param: led: number of LED given to LEDPWM_Attach()
+ * @param: level: final level
+ * @param: ms: duration of the fade
+ * @param: curve: brightness curve
+ * @note: Returns at once, the DMA writes one step every few PWM periods
+ */
+void LEDPWM_Fade(uint8_t led, uint8_t level, uint16_t ms, ledpwm_curve curve);
+
+/*
+ * @brief: Get the current level of a LED
+ * @param: led: number of LED given to LEDPWM_Attach()
+ * @return: level on the current curve (moves during a fade)
+ */
+uint8_t LEDPWM_GetLevel(uint8_t led);
+
+/*
+ * @brief: Test Routine, fades on LED3..LED5
+ */
+void Test_LEDPWM(void);
+
+#endif /* LEDPWM_H_ */
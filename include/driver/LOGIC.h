@@ -0,0 +1,120 @@
+/*
+ * =============================================================================
+ * File Name    : LOGIC.h
+ * Project      : S32K144_basic
+ * Module       : Logic Analyzer Module (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   On-chip logic analyzer for the S32K144. Every sample is a copy of the
+ *   whole PDIR register of one port plus a timestamp of the LPIT time base,
+ *   written to a RAM buffer by two linked eDMA channels with no CPU work.
+ *
+ *   Trigger modes:
+ *     - Edge  : pins configured with rising_DMA/falling_DMA/either_down_DMA
+ *               request one sample on each edge
+ *     - Timer : LPIT channel LPIT_CH_LOGIC requests samples at a fixed rate
+ *
+ *   LOGIC_Dump() prints the buffer as text, tools/la2vcd.py converts it to VCD.
+ *
+ * Dependencies :
+ *   - GPIO driver
+ *   - eDMA driver (channels DMA_CH_LOGIC_PORT and DMA_CH_LOGIC_TIME)
+ *   - LPIT driver (time base and LPIT_CH_LOGIC)
+ *
+ * Configuration :
+ *   - LOGIC_MAX_SAMPLES: maximum capture length
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+#ifndef LOGIC_H_
+#define LOGIC_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define LOGIC_MAX_SAMPLES              2048U
+#define LOGIC_RATE_EDGE                0U      // Rate value selecting the edge trigger
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+/* One capture record, written by the eDMA */
+typedef struct {
+    uint32_t port;                      // PDIR of the captured port
+    uint32_t time;                      // LPIT time base (raw down counter value)
+} logic_sample;
+
+typedef enum {
+    LOGIC_IDLE,
+    LOGIC_RUNNING,
+    LOGIC_DONE,
+} logic_state;
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Add a pin to the capture
+ * @param: ptx_n: pin to watch, all pins must belong to the same port
+ * @param: cfg: rising_DMA, falling_DMA or either_down_DMA (used in edge mode)
+ */
+void LOGIC_PinAdd(PTXn_e ptx_n, exti_cfg cfg);
+
+/*
+ * @brief: Start a capture
+ * @param: rate_hz: LOGIC_RATE_EDGE to sample on pin edges, or sample rate in Hz
+ * @param: buff: destination buffer
+ * @param: len: number of samples (1..LOGIC_MAX_SAMPLES)
+ * @return: true if the capture was started
+ */
+bool LOGIC_Start(uint32_t rate_hz, logic_sample *buff, uint16_t len);
+
+/*
+ * @brief: Abort the running capture
+ */
+void LOGIC_Stop(void);
+
+/*
+ * @brief: Get the capture state
+ * @return: LOGIC_IDLE, LOGIC_RUNNING or LOGIC_DONE
+ */
+logic_state LOGIC_GetState(void);
+
+/*
+ * @brief: Get the number of samples already written
+ * @return: samples in the buffer
+ */
+uint16_t LOGIC_GetCount(void);
+
+/*
+ * @brief: Print the captured samples through printf (see tools/la2vcd.py)
+ */
+void LOGIC_Dump(void);
+
+#endif /* LOGIC_H_ */
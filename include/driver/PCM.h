@@ -0,0 +1,118 @@
+/*
+ * =============================================================================
+ * File Name    : PCM.h
+ * Project      : S32K144_basic
+ * Module       : PCM Playback Module (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Plays 8-bit unsigned PCM samples on the buzzer pin. The samples set the
+ *   duty of the FTM0 PWM and the eDMA writes them to CnV once per PWM period,
+ *   so the CPU only refills half of a double buffer every few milliseconds.
+ *   Samples come from flash (PCM_Play()) or from a generator (PCM_Stream()).
+ *
+ * Dependencies :
+ *   - FTM driver (FTM0, shared with the BUZZ module)
+ *   - DMA driver (DMA_CH_PCM)
+ *
+ * Configuration :
+ *   - PCM_OVERSAMPLE: PWM periods per sample, the carrier is rate * PCM_OVERSAMPLE
+ *   - PCM_HALF_LEN: PWM periods per half buffer
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+#ifndef DRIVER_PCM_H_
+#define DRIVER_PCM_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define PCM_RATE_MIN                   8000U   // Hz
+#define PCM_RATE_MAX                   16000U  // Hz
+#define PCM_OVERSAMPLE                 2U      // Carrier 16..32 kHz, out of the audio band
+#define PCM_HALF_LEN                   128U    // CnV words per half buffer
+#define PCM_SAMPLES                    (PCM_HALF_LEN / PCM_OVERSAMPLE)
+#define PCM_SILENCE                    128U    // Middle of the 8-bit range
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+/*
+ * Sample generator, called from the DMA interrupt to fill half a buffer.
+ * Returns the samples written, less than count ends the stream.
+ */
+typedef uint16_t (*pcm_source)(uint8_t *samples, uint16_t count, void *ctx);
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+extern const uint8_t pcm_sine[64];
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Set up the DMA channel and the buzzer PWM
+ */
+void PCM_Init(void);
+
+/*
+ * @brief: Play samples stored in flash
+ * @param: data: 8-bit unsigned samples, must stay valid while playing
+ * @param: len: number of samples
+ * @param: rate_hz: sample rate, PCM_RATE_MIN..PCM_RATE_MAX
+ * @return: false if the rate is out of range
+ * @note: Stops the BUZZ sequencer and what is playing
+ */
+bool PCM_Play(const uint8_t *data, uint32_t len, uint16_t rate_hz);
+
+/*
+ * @brief: Play the samples of a generator
+ * @param: rate_hz: sample rate, PCM_RATE_MIN..PCM_RATE_MAX
+ * @param: source: generator, called twice before this function returns
+ * @param: ctx: user pointer passed back to the generator
+ * @return: false if the rate is out of range
+ * @note: Stops the BUZZ sequencer and what is playing
+ */
+bool PCM_Stream(uint16_t rate_hz, pcm_source source, void *ctx);
+
+/*
+ * @brief: Stop the playback, the output stays low
+ * @note: The BUZZ functions can be used again after this
+ */
+void PCM_Stop(void);
+
+/*
+ * @brief: Check if samples are playing
+ * @return: true until the last sample has been output
+ */
+bool PCM_IsBusy(void);
+
+/*
+ * @brief: Test Routine, plays a 440 Hz sine and a sweep
+ */
+void Test_PCM(void);
+
+#endif /* DRIVER_PCM_H_ */
@@ -0,0 +1,114 @@
+/*
+ * =============================================================================
+ * File Name    : RTTTL.h
+ * Project      : S32K144_basic
+ * Module       : RTTTL Melody Parser (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Streaming parser for RTTTL ringtones ("name:d=4,o=5,b=120:8c6,8e6,g6").
+ *   Text is consumed one char at a time and every note is queued to the BUZZ
+ *   sequencer as soon as it is complete, so a song never has to be stored in
+ *   RAM: the parser state is a few bytes whatever the length of the song.
+ *
+ *   Songs can come from flash (RTTTL_Play()) or from a UART (RTTTL_UartInit()),
+ *   one song per line. The UART side uses a small receive buffer with XON/XOFF
+ *   flow control, so a terminal can send a long song at full speed.
+ *
+ * Dependencies :
+ *   - BUZZ module (note queue)
+ *   - UART driver (receive interrupt)
+ *
+ * Configuration :
+ *   - RTTTL_RX_LEN: UART receive buffer
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+#ifndef DRIVER_RTTTL_H_
+#define DRIVER_RTTTL_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define RTTTL_RX_LEN                   64U
+#define RTTTL_XOFF_LEVEL               48U     // Sender paused above this level
+#define RTTTL_XON_LEVEL                16U     // Sender resumed below this level
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+extern const char rtttl_demo[];
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Reset the parser, waits for the name of a new song
+ */
+void RTTTL_Init(void);
+
+/*
+ * @brief: Feed one char to the parser
+ * @param: c: next char, a new line or '\0' ends the song
+ * @return: false if the note queue is full, give the same char again later.
+ *          The end of a song is only taken once its last note is queued
+ */
+bool RTTTL_Putc(char c);
+
+/*
+ * @brief: Play a song stored in flash
+ * @param: text: RTTTL string ending with '\0', must stay valid while playing
+ * @note: Stops what is playing. The text is parsed by RTTTL_Task()
+ */
+void RTTTL_Play(const char *text);
+
+/*
+ * @brief: Play the songs received by a UART, one per line
+ * @param: base, LPUART0, LPUART1, LPUART2 (initialized with UART_Init())
+ */
+void RTTTL_UartInit(LPUART_Type *base);
+
+/*
+ * @brief: Parse the pending text while there is room in the note queue
+ * @note: Call it from the main loop, it never blocks
+ */
+void RTTTL_Task(void);
+
+/*
+ * @brief: Get the number of chars lost by the UART buffer
+ * @return: chars dropped since RTTTL_UartInit() (sender ignoring XOFF)
+ */
+uint32_t RTTTL_GetLost(void);
+
+/*
+ * @brief: Test Routine, plays rtttl_demo and then the songs sent on LPUART0
+ */
+void Test_RTTTL(void);
+
+#endif /* DRIVER_RTTTL_H_ */
@@ -0,0 +1,164 @@
+/*
+ * =============================================================================
+ * File Name    : S32K_DMA.h
+ * Project      : S32K144_basic
+ * Module       : eDMA / DMAMUX Driver (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Minimal driver for the 16-channel eDMA controller and its DMAMUX on the
+ *   NXP S32K144. Transfers are described with a software TCD that is copied to
+ *   the channel, or linked from another TCD in RAM for scatter/gather chains.
+ *
+ *   Channel allocation in this project:
+ *     - DMA_CH_PCM        : 0 (FTM0 OR'd channel request, buzzer samples)
+ *     - DMA_CH_BUZZ_ENV   : 1 (periodic trigger from LPIT channel 1, tick)
+ *     - DMA_CH_LOGIC_PORT : 3 (periodic trigger from LPIT channel 3)
+ *     - DMA_CH_LOGIC_TIME : 4
+ *     - DMA_CH_CAPTURE    : 5 (FTM input capture offload)
+ *     - DMA_CH_LEDPWM_DIV : 6..8 (LED fade period dividers)
+ *     - DMA_CH_LEDPWM_WR  : 9..11 (LED fade CnV writers)
+ *     - DMA_CH_WS2812     : 12 (LPSPI1 TX, LED strip)
+ *     - DMA_CH_DISPLAY_*  : 13..15 (multiplexed display, FTM2 ch0/ch1)
+ *
+ * Dependencies :
+ *   - None
+ *
+ * Configuration :
+ *   - Channels 0..3 can be triggered periodically by LPIT channels 0..3
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+#ifndef DRIVER_S32K_DMA_H_
+#define DRIVER_S32K_DMA_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define DMA_CH_NUM                     16U
+
+/* Channel allocation */
+#define DMA_CH_PCM                     0U      // PCM samples to FTM0 CnV (FTM0 ch0)
+#define DMA_CH_BUZZ_ENV                1U      // Buzzer envelope to FTM0 CnV (LPIT ch1 trigger)
+#define DMA_CH_LOGIC_PORT              3U      // Logic analyzer PDIR copy (LPIT ch3 trigger)
+#define DMA_CH_LOGIC_TIME              4U      // Logic analyzer timestamp copy
+#define DMA_CH_CAPTURE                 5U      // FTM input capture CnV copy
+#define DMA_CH_LEDPWM_DIV              6U      // 6..8: LED fade dividers (FTM1 channel match)
+#define DMA_CH_LEDPWM_WR               9U      // 9..11: LED fade CnV writers (linked)
+#define DMA_CH_WS2812                  12U     // LED strip bitstream to LPSPI1 TDR
+#define DMA_CH_DISPLAY_ROW             13U     // Display row words (FTM2 ch0)
+#define DMA_CH_DISPLAY_ON              14U     // Display row on-time (linked)
+#define DMA_CH_DISPLAY_BLANK           15U     // Display blanking (FTM2 ch1)
+
+/* Transfer size for the ATTR field */
+#define DMA_SIZE_8BIT                  0U
+#define DMA_SIZE_16BIT                 1U
+#define DMA_SIZE_32BIT                 2U
+
+/* TCD attributes for a source and destination size */
+#define DMA_ATTR(ssize, dsize)         (DMA_TCD_ATTR_SSIZE(ssize) | DMA_TCD_ATTR_DSIZE(dsize))
+
+/* Major loop count with minor loop link to another channel (count up to 511) */
+#define DMA_ITER_LINK(ch, count)       (DMA_TCD_CITER_ELINKYES_ELINK_MASK | \
+                                        DMA_TCD_CITER_ELINKYES_LINKCH(ch) | \
+                                        DMA_TCD_CITER_ELINKYES_CITER_LE(count))
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+/* Software image of a Transfer Control Descriptor, same layout as the hardware */
+typedef struct {
+    uint32_t saddr;                     // Source address
+    int16_t  soff;                      // Source offset after each read
+    uint16_t attr;                      // Transfer size and modulo
+    uint32_t nbytes;                    // Bytes per minor loop
+    int32_t  slast;                     // Source adjustment after the major loop
+    uint32_t daddr;                     // Destination address
+    int16_t  doff;                      // Destination offset after each write
+    uint16_t citer;                     // Current major loop count (and link)
+    int32_t  dlast_sga;                 // Destination adjustment or next TCD
+    uint16_t csr;                       // Control and status
+    uint16_t biter;                     // Beginning major loop count (and link)
+} __attribute__((aligned(32))) dma_tcd;
+
+/* Callback executed from the channel interrupt */
+typedef void (*dma_callback)(uint8_t ch, void *ctx);
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Enable the eDMA and DMAMUX clocks
+ */
+void DMA_Init(void);
+
+/*
+ * @brief: Route a request source to a channel
+ * @param: ch: DMA channel (0..15)
+ * @param: source: request source, check dma_request_source_t
+ * @param: periodic: true to gate the request with the LPIT channel of the same
+ *         number (only channels 0..3)
+ */
+void DMA_ChannelMux(uint8_t ch, dma_request_source_t source, bool periodic);
+
+/*
+ * @brief: Copy a software TCD into the channel
+ * @param: ch: DMA channel (0..15)
+ * @param: tcd: descriptor to load
+ */
+void DMA_TcdLoad(uint8_t ch, const dma_tcd *tcd);
+
+/*
+ * @brief: Register the major loop callback and enable the channel interrupt
+ * @param: ch: DMA channel (0..15)
+ * @param: callback: function called on major loop (or half) completion
+ * @param: ctx: user pointer passed back to the callback
+ */
+void DMA_ChannelAttach(uint8_t ch, dma_callback callback, void *ctx);
+
+/*
+ * @brief: Enable the hardware requests of a channel
+ * @param: ch: DMA channel (0..15)
+ */
+void DMA_ChannelStart(uint8_t ch);
+
+/*
+ * @brief: Disable the hardware requests of a channel
+ * @param: ch: DMA channel (0..15)
+ */
+void DMA_ChannelStop(uint8_t ch);
+
+/*
+ * @brief: Get the remaining major loop count of a channel
+ * @param: ch: DMA channel (0..15)
+ * @param: linked: true if the channel uses minor loop linking
+ * @return: current major loop count
+ */
+uint16_t DMA_GetCiter(uint8_t ch, bool linked);
+
+#endif /* DRIVER_S32K_DMA_H_ */
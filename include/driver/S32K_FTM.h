@@ -0,0 +1,200 @@
+/*
+ * =============================================================================
+ * File Name    : S32K_FTM.h
+ * Project      : S32K144_basic
+ * Module       : FlexTimer Driver (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Basic driver for the four FlexTimer modules of the NXP S32K144. It owns the
+ *   pin to channel mux table, the counter clock and the channel and overflow
+ *   interrupts. On top of it, an input capture service latches the counter in
+ *   hardware on every edge and extends it to a 64-bit timestamp, so the edge
+ *   time does not depend on the interrupt latency.
+ *
+ * Dependencies :
+ *   - S32K_DMA (optional capture offload)
+ *
+ * Configuration :
+ *   - Counter clocked from SOSCDIV1_CLK (8 MHz), 125 ns resolution with
+ *     prescaler 1
+ *   - FTM1/FTM2 have one DMA request per channel, FTM0/FTM3 only one request
+ *     shared by all their channels
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+#ifndef DRIVER_S32K_FTM_H_
+#define DRIVER_S32K_FTM_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define FTM_CLK_HZ                     CLOCK_SOSC_HZ   // SOSCDIV1_CLK, crystal divided by 1
+#define FTM_NUM                        4U
+#define FTM_CH_NUM                     8U
+
+/* Input capture service */
+#define FTM_CAPTURE_SLOTS              4U      // Channels capturing at the same time
+#define FTM_CAPTURE_RING               16U     // Timestamps per channel, power of 2
+#define FTM_CAPTURE_DMA_LEN            32U     // Raw DMA samples, power of 2
+
+/* Conversion from timestamp ticks (prescaler 1) to microseconds */
+#define FTM_TICKS_TO_US(t)             ((t) / (FTM_CLK_HZ / 1000000U))
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+/* Edge latched by an input capture channel (ELSB:ELSA) */
+typedef enum {
+    FTM_CAPTURE_RISING  = 1,
+    FTM_CAPTURE_FALLING = 2,
+    FTM_CAPTURE_BOTH    = 3,
+} ftm_capture_edge;
+
+/* Callback executed from the channel or overflow interrupt */
+typedef void (*ftm_callback)(uint8_t ftm, uint8_t ch, void *ctx);
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+extern FTM_Type *const FTMX[FTM_NUM];
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Enable the clock of a module and start its free running counter
+ * @param: ftm: FTM module (0..3)
+ * @param: ps: prescaler, counter runs at FTM_CLK_HZ >> ps (0..7)
+ * @param: mod: counter modulo, the period is mod + 1 ticks
+ * @note: The overflow interrupt is only enabled by the services that need it
+ *        (input capture, FTM_OverflowAttach())
+ */
+void FTM_Init(uint8_t ftm, uint8_t ps, uint16_t mod);
+
+/*
+ * @brief: Find the FTM channel of a pin, the pin is not changed
+ * @param: ptx_n: pin, check the mux table in S32K_FTM.c
+ * @param: ftm: returns the FTM module
+ * @param: ch: returns the channel
+ * @return: false if the pin is not connected to any FTM channel
+ */
+bool FTM_PinFind(PTXn_e ptx_n, uint8_t *ftm, uint8_t *ch);
+
+/*
+ * @brief: Find the FTM channel of a pin and route the pin to it
+ * @param: ptx_n: pin, check the mux table in S32K_FTM.c
+ * @param: ftm: returns the FTM module
+ * @param: ch: returns the channel
+ * @return: false if the pin is not connected to any FTM channel
+ */
+bool FTM_PinMux(PTXn_e ptx_n, uint8_t *ftm, uint8_t *ch);
+
+/*
+ * @brief: Route a pin to its channel as edge aligned PWM output
+ * @param: ptx_n: pin, check the mux table in S32K_FTM.c
+ * @param: low_true: true if the output is active low
+ * @param: ftm: returns the FTM module
+ * @param: ch: returns the channel
+ * @return: false if the pin is not connected to any FTM channel
+ * @note: Starts at 0% duty. CnV writes are loaded at the end of the period
+ *        (PWMLOAD), so duty changes never cut a period.
+ */
+bool FTM_PwmInit(PTXn_e ptx_n, bool low_true, uint8_t *ftm, uint8_t *ch);
+
+/*
+ * @brief: Change the period and the duty of a PWM channel at once
+ * @param: ftm: FTM module (0..3)
+ * @param: ch: channel set up by FTM_PwmInit()
+ * @param: ps: prescaler, counter runs at FTM_CLK_HZ >> ps (0..7)
+ * @param: mod: counter modulo, the period is mod + 1 ticks
+ * @param: cnv: duty in ticks
+ * @note: The counter is stopped for the update and restarts from 0, so the
+ *        new period starts at once (the other channels of the module too)
+ */
+void FTM_PwmPeriod(uint8_t ftm, uint8_t ch, uint8_t ps, uint16_t mod, uint16_t cnv);
+
+/*
+ * @brief: Register the interrupt callback of a channel
+ * @param: ftm: FTM module (0..3)
+ * @param: ch: channel (0..7)
+ * @param: callback: function called when the channel flag is set (NULL: none)
+ * @param: ctx: user pointer passed back to the callback
+ */
+void FTM_ChannelAttach(uint8_t ftm, uint8_t ch, ftm_callback callback, void *ctx);
+
+/*
+ * @brief: Register the overflow callback of a module
+ * @param: ftm: FTM module (0..3)
+ * @param: callback: function called on every counter overflow (ch is 0xFF)
+ * @param: ctx: user pointer passed back to the callback
+ */
+void FTM_OverflowAttach(uint8_t ftm, ftm_callback callback, void *ctx);
+
+/*
+ * @brief: Get the 64-bit extended counter of a module
+ * @param: ftm: FTM module (0..3)
+ * @return: ticks since FTM_Init(), counting the overflows
+ * @note: Overflows are only counted once a capture or overflow callback is set
+ */
+uint64_t FTM_GetTime(uint8_t ftm);
+
+/*
+ * @brief: Start timestamping the edges of a pin
+ * @param: ptx_n: pin connected to an FTM channel
+ * @param: edge: edge(s) to latch
+ * @param: dma: true to copy the latched values with DMA instead of interrupts
+ * @return: false if the pin has no FTM channel, no slot is free, or dma is
+ *          asked on FTM0/FTM3
+ * @note: The FTM must be initialized with FTM_Init() first. Only one channel
+ *        can use the DMA offload (DMA_CH_CAPTURE), on FTM1 or FTM2: FTM0 and
+ *        FTM3 have a single request for all their channels, and PCM uses the
+ *        FTM0 one. The overflow interrupt extends the DMA values once per
+ *        counter period, so it must not be masked for longer than that.
+ */
+bool FTM_CaptureInit(PTXn_e ptx_n, ftm_capture_edge edge, bool dma);
+
+/*
+ * @brief: Stop timestamping a pin and free its slot
+ * @param: ptx_n: pin given to FTM_CaptureInit()
+ */
+void FTM_CaptureStop(PTXn_e ptx_n);
+
+/*
+ * @brief: Get the oldest timestamp of a pin
+ * @param: ptx_n: pin given to FTM_CaptureInit()
+ * @param: time: returns the extended counter value of the edge
+ * @return: false if no edge is pending
+ */
+bool FTM_CaptureRead(PTXn_e ptx_n, uint64_t *time);
+
+/*
+ * @brief: Get the number of edges lost because the ring was full
+ * @param: ptx_n: pin given to FTM_CaptureInit()
+ * @return: lost edges since FTM_CaptureInit()
+ */
+uint32_t FTM_CaptureGetLost(PTXn_e ptx_n);
+
+#endif /* DRIVER_S32K_FTM_H_ */
@@ -17,6 +17,8 @@
  *     - Configurable GPIO direction (input/output)
  *     - Support for passive filters, pull-up/down resistors
  *     - External interrupt trigger configuration (edge/level)
+ *     - Per-pin external interrupt callbacks with event counters
+ *     - Digital glitch filter (DFER/DFCR/DFWR) per pin
  *     - Bit-level, byte-level, and word-level pin control
  *     - Input/output direction configuration macros
  *
@@ -762,6 +764,19 @@ typedef enum exti_cfg
     one_up          = 0x8Cu     // High level trigger, internal pull-up
 } exti_cfg;
 
+// Define the clock of the digital input filter (DFCR), shared by the whole port
+typedef enum GPIO_DF_CLK
+{
+    GPIO_DF_BUS     = 0x00,     // Bus clock, best resolution, short glitches only
+    GPIO_DF_LPO     = 0x01,     // 128 kHz LPO clock, up to 31 * 7.8 us
+} GPIO_DF_CLK;
+
+#define GPIO_DF_LPO_HZ      128000U     // LPO clock of the digital filter
+#define GPIO_DF_WIDTH_MAX   31U         // Maximum filter length in clock cycles (DFWR)
+
+/* Callback executed from PORTx_IRQHandler for every pending pin of the port */
+typedef void (*gpio_exti_callback)(PTXn_e ptx_n, void *ctx);
+
 extern GPIO_MemMapPtr GPIOX[5];
 extern PORT_MemMapPtr PORTX[5];
 
@@ -817,4 +832,66 @@ void GPIO_PortPull(PTXn_e ptx_n, bool pullup_ena);
  */
 void GPIO_ExtiInit(PTXn_e ptx_n, exti_cfg cfg);
 
+
+/* @brief Register a callback for a pin and initialize its external interrupt
+ * @param ptx_n: GPIO to be initialized, defined in common.h
+ * @param cfg: interrupt trigger mode, such as: falling_up // falling edge trigger, internal pull-up
+ * @param callback: function called from the port handler when the pin flag is set (NULL only counts)
+ * @param ctx: user pointer passed back to the callback
+ * @note Every pending pin of the port is served in the same interrupt, and NVIC_EnableIRQ() is
+ *       still required to enable the kernel interrupt
+ */
+void GPIO_ExtiAttach(PTXn_e ptx_n, exti_cfg cfg, gpio_exti_callback callback, void *ctx);
+
+
+/* @brief Disable the external interrupt of a pin and remove its callback
+ * @param ptx_n: GPIO to be released, defined in common.h
+ */
+void GPIO_ExtiDetach(PTXn_e ptx_n);
+
+
+/* @brief Get the number of interrupt events served for a pin
+ * @param ptx_n: GPIO to be checked, defined in common.h
+ * @return number of events since the pin was attached
+ */
+uint32_t GPIO_ExtiGetCount(PTXn_e ptx_n);
+
+/*
+ * @brief: Disable the interrupt of a pin, keeping its callback
+ * @param: ptx_n: Select port
+ */
+void GPIO_ExtiMask(PTXn_e ptx_n);
+
+/*
+ * @brief: Enable again the interrupt of a pin masked with GPIO_ExtiMask()
+ * @param: ptx_n: Select port
+ * @param: cfg: trigger mode, only the edge or level bits are used
+ * @note: A flag raised while the pin was masked is discarded
+ */
+void GPIO_ExtiUnmask(PTXn_e ptx_n, exti_cfg cfg);
+
+
+/* @brief Enable the digital glitch filter of a pin
+ * @param ptx_n: GPIO to be filtered, defined in common.h
+ * @param clk: filter clock, GPIO_DF_BUS or GPIO_DF_LPO
+ * @param width: pulses shorter than width clock cycles are rejected (1..GPIO_DF_WIDTH_MAX)
+ * @note The clock and the width are common to every filtered pin of the port
+ */
+void GPIO_DigitalFilterInit(PTXn_e ptx_n, GPIO_DF_CLK clk, uint8_t width);
+
+
+/* @brief Disable the digital glitch filter of a pin
+ * @param ptx_n: GPIO to be released, defined in common.h
+ */
+void GPIO_DigitalFilterDisable(PTXn_e ptx_n);
+
+
+/* @brief Convert a filter length in microseconds into a clock and a width
+ * @param us: shortest pulse to be accepted, in microseconds
+ * @param clk: selected clock, bus clock when it is long enough, LPO otherwise
+ * @param width: number of filter clock cycles
+ * @return true if the length can be reached, false if width was limited to GPIO_DF_WIDTH_MAX
+ */
+bool GPIO_DigitalFilterUs(uint32_t us, GPIO_DF_CLK *clk, uint8_t *width);
+
 #endif /* S32K_GPIO_H_ */
@@ -0,0 +1,159 @@
+/*
+ * =============================================================================
+ * File Name    : S32K_LPIT.h
+ * Project      : S32K144_basic
+ * Module       : LPIT Timer Driver (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Driver for the 4-channel Low Power Interrupt Timer (LPIT0) on the NXP
+ *   S32K144. Channel 0 runs free as a 32-bit time base, extended to 64 bits
+ *   by counting its wraps (one interrupt every 2^32 ticks, 537 s at 8 MHz).
+ *   The remaining channels are periodic timers with an interrupt callback or
+ *   a DMA trigger.
+ *
+ *   Channel allocation in this project:
+ *     - LPIT_CH_TIMESTAMP : 0 (free running time base)
+ *     - LPIT_CH_TICK      : 1 (1 ms software tick shared by several callbacks)
+ *     - LPIT_CH_BAM       : 2 (bit angle modulation slots)
+ *     - LPIT_CH_LOGIC     : 3 (logic analyzer sample trigger, DMA channel 3)
+ *
+ * Dependencies :
+ *   - SOSC configured with SOSCDIV2 = 1 (via S32K_PLL.h)
+ *
+ * Configuration :
+ *   - LPIT_CLK_HZ: functional clock of the timer
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+#ifndef DRIVER_S32K_LPIT_H_
+#define DRIVER_S32K_LPIT_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define LPIT_CLK_HZ                    CLOCK_SOSC_HZ   // SOSCDIV2_CLK, crystal divided by 1
+#define LPIT_CH_NUM                    4U
+
+/* Channel allocation */
+#define LPIT_CH_TIMESTAMP              0U      // Free running time base
+#define LPIT_CH_TICK                   1U      // Software tick
+#define LPIT_CH_BAM                    2U      // Bit angle modulation slot timer
+#define LPIT_CH_LOGIC                  3U      // Logic analyzer sample trigger
+
+/* Software tick */
+#define LPIT_TICK_US                   1000U   // Tick period
+#define LPIT_TICK_SLOTS                8U      // Callbacks sharing the tick
+
+/* Conversion from microseconds to timer ticks */
+#define LPIT_US_TO_TICKS(us)           ((uint32_t)(us) * (LPIT_CLK_HZ / 1000000U))
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+/* Callback executed from the channel interrupt */
+typedef void (*lpit_callback)(void *ctx);
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Enable the LPIT clock and start the free running time base
+ * @note: Can be called by every module using the timer
+ */
+void LPIT_Init(void);
+
+/*
+ * @brief: Configure a periodic channel
+ * @param: ch: LPIT channel (1..3)
+ * @param: ticks: period in LPIT_CLK_HZ ticks
+ * @param: callback: function called on every timeout (NULL: no interrupt)
+ * @param: ctx: user pointer passed back to the callback
+ * @note: The channel is left stopped, use LPIT_ChannelStart()
+ */
+void LPIT_ChannelInit(uint8_t ch, uint32_t ticks, lpit_callback callback, void *ctx);
+
+/*
+ * @brief: Start a channel
+ * @param: ch: LPIT channel (1..3)
+ */
+void LPIT_ChannelStart(uint8_t ch);
+
+/*
+ * @brief: Stop a channel
+ * @param: ch: LPIT channel (1..3)
+ */
+void LPIT_ChannelStop(uint8_t ch);
+
+/*
+ * @brief: Change the period of a running channel
+ * @param: ch: LPIT channel (1..3)
+ * @param: ticks: period in LPIT_CLK_HZ ticks
+ * @note: The new period is used after the current one expires
+ */
+void LPIT_SetPeriod(uint8_t ch, uint32_t ticks);
+
+/*
+ * @brief: Get the free running time base
+ * @return: LPIT_CLK_HZ ticks since LPIT_Init(), wraps every 2^32 ticks
+ */
+uint32_t LPIT_GetTimestamp(void);
+
+/*
+ * @brief: Get the free running time base extended with its wrap count
+ * @return: LPIT_CLK_HZ ticks since LPIT_Init(), does not wrap
+ */
+uint64_t LPIT_GetTimestamp64(void);
+
+/*
+ * @brief: Call a function periodically from the software tick
+ * @param: callback: function called from the LPIT_CH_TICK interrupt
+ * @param: ctx: user pointer passed back to the callback
+ * @param: period: number of ticks between calls (1 = every LPIT_TICK_US)
+ * @return: false if all the tick slots are used
+ * @note: The tick channel is started with the first callback and stopped
+ *        when the last one is detached
+ */
+bool LPIT_TickAttach(lpit_callback callback, void *ctx, uint16_t period);
+
+/*
+ * @brief: Remove a callback from the software tick
+ * @param: callback: function given to LPIT_TickAttach()
+ * @param: ctx: user pointer given to LPIT_TickAttach()
+ */
+void LPIT_TickDetach(lpit_callback callback, void *ctx);
+
+/*
+ * @brief: Get the software tick count
+ * @return: ticks of LPIT_TICK_US since LPIT_Init()
+ * @note: Derived from LPIT_GetTimestamp64(), so it is current even while
+ *        the tick channel is stopped
+ */
+uint32_t LPIT_GetTicks(void);
+
+#endif /* DRIVER_S32K_LPIT_H_ */
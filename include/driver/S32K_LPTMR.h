@@ -0,0 +1,89 @@
+/*
+ * =============================================================================
+ * File Name    : S32K_LPTMR.h
+ * Project      : S32K144_basic
+ * Module       : LPTMR Timer Driver (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   One-shot millisecond timer on the Low Power Timer (LPTMR0) of the NXP
+ *   S32K144. It runs from the 1 kHz LPO clock, so it keeps counting while the
+ *   core sleeps and costs no interrupt until it expires.
+ *
+ * Dependencies :
+ *   - LPO1K_CLK enabled (reset default)
+ *
+ * Configuration :
+ *   - 1 ms resolution, up to 65535 ms
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+#ifndef DRIVER_S32K_LPTMR_H_
+#define DRIVER_S32K_LPTMR_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+/* Callback executed from the timer interrupt */
+typedef void (*lptmr_callback)(void *ctx);
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Enable the LPTMR clock and select the 1 kHz LPO
+ * @note: Called by LPTMR_OneShot(), safe to call more than once
+ */
+void LPTMR_Init(void);
+
+/*
+ * @brief: Call a function once after a delay
+ * @param: ms: delay in milliseconds (1..65535)
+ * @param: callback: function called from the interrupt when the delay expires
+ * @param: ctx: user pointer passed back to the callback
+ * @note: A running one-shot is restarted with the new delay
+ */
+void LPTMR_OneShot(uint16_t ms, lptmr_callback callback, void *ctx);
+
+/*
+ * @brief: Cancel the running one-shot
+ */
+void LPTMR_Stop(void);
+
+/*
+ * @brief: Check if a one-shot is running
+ * @return: true until the callback has been called or LPTMR_Stop()
+ */
+bool LPTMR_IsRunning(void);
+
+#endif /* DRIVER_S32K_LPTMR_H_ */
@@ -8,24 +8,26 @@
  * Version      : 1.0.0
  *
  * Description  :
- *   This header file provides functions and configuration options to initialize
- *   the system clocks on the NXP S32K144 microcontroller. It supports setting up
- *   the System PLL (SPLL), external oscillator (XOSC), and RUN mode transitions.
+ *   This header file provides functions to initialize the system clocks on the
+ *   NXP S32K144 microcontroller. CLOCK_Solve() searches the SPLL and SCG
+ *   dividers for the requested core, bus and slow clocks and checks them
+ *   against the limits of RUN and HSRUN, and CLOCK_Apply() programs them.
  *
- *   Clock configuration options are defined in the `clk_option` enumeration, with
- *   recommended and unstable values annotated.
+ *   clock_get_hz() decodes the SCG registers, so drivers always get the clock
+ *   in use, whoever configured it.
  *
- *   Example values:
- *     - PLL160: Recommended stable configuration
- *     - PLL220: Unstable
- *     - PLL252: Very unstable (not recommended)
+ *   CLOCK_SetProfile() moves between HSRUN, RUN and VLPR at run time. Drivers
+ *   whose timing depends on a clock register a notifier and recompute their
+ *   dividers (UART baud, systime factors, FTM, LPIT and LPSPI clock source)
+ *   while the interrupts are disabled.
  *
  * Dependencies :
  *   - Device-specific SCG, SPLL, and SOSC register definitions
  *
  * Configuration :
- *   - XOSC expected to operate at 8 MHz
- *   - Default RUN mode transitions to 80 MHz using PLL
+ *   - CLOCK_SOSC_HZ: crystal frequency (SOSCDIV1 and SOSCDIV2 divide by 1)
+ *   - Default RUN mode: 80 MHz core, 40 MHz bus, 26.67 MHz flash from the SPLL
+ *   - VLPR: 4 MHz core and bus, 1 MHz flash, SIRCDIV1 and SIRCDIV2 at 8 MHz
  *
  * License :
  *   This file is part of a free software project released under the terms of
@@ -54,56 +56,168 @@
 //==============================================================================
 //                         PUBLIC DEFINES AND MACROS
 //==============================================================================
+#define CLOCK_SOSC_HZ                  8000000U    // Crystal, also SOSCDIV1_CLK and SOSCDIV2_CLK
+
+/* Default configuration of CLOCK_Init() */
+#define CLOCK_CORE_HZ                  80000000U
+#define CLOCK_BUS_HZ                   40000000U
+#define CLOCK_SLOW_HZ                  26666667U
+
+#define CLOCK_VLPR_CORE_HZ             4000000U    // SIRC / 2, core and bus in VLPR
+#define CLOCK_NOTIFIER_SLOTS           8U
 
 //==============================================================================
-//                         PUBLIC GLOBAL VARIABLES
+//                        PUBLIC TYPES AND ENUMERATIONS
 //==============================================================================
-extern uint32 core_clk_M;	//MHZ
-extern uint32 bus_clk_M;	//MHZ
-
-// PLL Parameters (Phase-locked loop)
-typedef enum clk_option
-{
-    PLLUNULL ,
-    PLL100   = 100,
-    PLL112   = 112,
-    PLL160   = 160,			// Recommended stable configuration
-    PLL180   = 180,
-    PLL184   = 184,
-    PLL188   = 188,
-
-    PLL200   = 200,
-    PLL220   = 220,         // Unstable
-    PLL252   = 252,         // Very unstable (not recommended)
-    PLLtest,
-} clk_option;
+/* Clocks returned by clock_get_hz() */
+typedef enum {
+    CLOCK_CORE,                         // Core and system (DIVCORE)
+    CLOCK_BUS,                          // Bus (DIVBUS)
+    CLOCK_SLOW,                         // Slow and flash (DIVSLOW)
+    CLOCK_SOSC,
+    CLOCK_SOSCDIV1,
+    CLOCK_SOSCDIV2,
+    CLOCK_SIRC,
+    CLOCK_SIRCDIV1,
+    CLOCK_SIRCDIV2,
+    CLOCK_FIRC,
+    CLOCK_SPLL,
+    CLOCK_SPLLDIV1,
+    CLOCK_SPLLDIV2,
+} clock_name;
+
+/* Power mode needed by a configuration */
+typedef enum {
+    CLOCK_MODE_RUN,                     // Core <= 80 MHz, bus <= 40 MHz, flash <= 26.67 MHz
+    CLOCK_MODE_HSRUN,                   // Core <= 112 MHz, bus <= 56 MHz, flash <= 28 MHz
+} clock_mode;
+
+/* Result of CLOCK_Solve(), register field values and the clocks they give */
+typedef struct {
+    uint32_t sosc_hz;
+    clock_mode mode;
+    uint8_t prediv;                     // SPLLCFG fields
+    uint8_t mult;
+    uint8_t divcore;                    // RCCR / HCCR fields (divider - 1)
+    uint8_t divbus;
+    uint8_t divslow;
+    uint8_t splldiv1;                   // SPLLDIV fields (1: /1 .. 7: /64)
+    uint8_t splldiv2;
+    uint32_t spll_hz;
+    uint32_t core_hz;
+    uint32_t bus_hz;
+    uint32_t slow_hz;
+} clock_config;
 
+/* Operating points of CLOCK_SetProfile() */
+typedef enum {
+    CLOCK_PROFILE_HSRUN,                // 112 MHz core from the SPLL
+    CLOCK_PROFILE_RUN,                  // 80 MHz core from the SPLL
+    CLOCK_PROFILE_VLPR,                 // 4 MHz core from SIRC, SOSC and SPLL stopped
+} clock_profile;
+
+/* Events given to the notifiers */
+typedef enum {
+    CLOCK_PRE_CHANGE,                   // The old clocks still run
+    CLOCK_POST_CHANGE,                  // The new clocks run
+} clock_event;
+
+/* Called with the interrupts disabled around a profile change */
+typedef void (*clock_notifier)(clock_event event, clock_profile profile, void *ctx);
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
 
 //==============================================================================
 //                        PUBLIC FUNCTION DECLARATIONS
 //==============================================================================
 
 /*
- * @brief: CPU Initialize
+ * @brief: Find the SPLL and dividers for the requested clocks
+ * @param: sosc_hz: crystal frequency
+ * @param: core_hz: core clock, the closest value not above it is used
+ * @param: bus_hz: highest bus clock
+ * @param: slow_hz: highest slow (flash) clock
+ * @param: cfg: returns the configuration
+ * @return: false if no configuration fits the limits of RUN or HSRUN
+ * @note: RUN is chosen whenever the clocks fit it. Only computes, the
+ *        registers are not touched
  */
-void MCU_Init(void);
+bool CLOCK_Solve(uint32_t sosc_hz, uint32_t core_hz, uint32_t bus_hz, uint32_t slow_hz, clock_config *cfg);
+
+/*
+ * @brief: Program SOSC, SPLL, the system dividers and the power mode
+ * @param: cfg: configuration given by CLOCK_Solve()
+ * @note: The core runs from FIRC while the SPLL is reprogrammed. Not for
+ *        VLPR, use CLOCK_SetProfile() to leave it
+ */
+void CLOCK_Apply(const clock_config *cfg);
+
+/*
+ * @brief: Solve and apply a configuration with the CLOCK_SOSC_HZ crystal
+ * @param: core_hz, bus_hz, slow_hz: see CLOCK_Solve()
+ * @return: false if the clocks are not possible, nothing is changed
+ */
+bool CLOCK_Init(uint32_t core_hz, uint32_t bus_hz, uint32_t slow_hz);
 
+/*
+ * @brief: Get the frequency of a clock, from the SCG registers
+ * @param: clk: clock, check clock_name
+ * @return: frequency in Hz, 0 if the clock is disabled
+ */
+uint32_t clock_get_hz(clock_name clk);
 
 /*
- * @brief: PLL Initialize
- * @param: opt: main frequency, (check clk_option)
+ * @brief: Get the current operating point, from the power mode
+ * @return: CLOCK_PROFILE_HSRUN, CLOCK_PROFILE_RUN or CLOCK_PROFILE_VLPR
  */
-void SPLL_Init(clk_option opt);
+clock_profile CLOCK_GetProfile(void);
 
+/*
+ * @brief: Change the operating point at run time
+ * @param: profile: new operating point, check clock_profile
+ * @return: false if the SPLL cannot give the clocks of the profile
+ * @note: The whole change runs with the interrupts disabled: the notifiers
+ *        get CLOCK_PRE_CHANGE, the clocks and the power mode change, then the
+ *        notifiers get CLOCK_POST_CHANGE. VLPR stops SOSC, FIRC and the SPLL,
+ *        the timers move to the SIRC dividers, which also give 8 MHz
+ */
+bool CLOCK_SetProfile(clock_profile profile);
+
+/*
+ * @brief: Register a driver to be told about profile changes
+ * @param: callback: function called before and after each change
+ * @param: ctx: user pointer passed back to the callback
+ * @return: false if all the notifier slots are used
+ * @note: CLOCK_PRE_CHANGE is given in the reverse order of registration,
+ *        CLOCK_POST_CHANGE in the order of registration. Registering the
+ *        same callback and ctx again does nothing
+ */
+bool CLOCK_NotifierAttach(clock_notifier callback, void *ctx);
+
+/*
+ * @brief: Remove a notifier
+ * @param: callback: function given to CLOCK_NotifierAttach()
+ * @param: ctx: user pointer given to CLOCK_NotifierAttach()
+ */
+void CLOCK_NotifierDetach(clock_notifier callback, void *ctx);
+
+/*
+ * @brief: CPU Initialize
+ * @note: HSRUN, 112 MHz core, 56 MHz bus, 28 MHz flash
+ */
+void MCU_Init(void);
 
 /*
  * @brief: SCG Initialize
- * @note: Initialize XOSC (8MHz), SPLL (160MHz) and RUN mode
+ * @note: Enables the port clocks and sets RUN mode, 80 MHz core, 40 MHz bus,
+ *        20 MHz flash
  */
 void SCG_Init(void);
 
 /*
- * @brief: Change to normal RUN mode with 8MHz SOSC, 80 MHz PLL
+ * @brief: Change to normal RUN mode with 8MHz SOSC, 80 MHz core
  */
 void NormalRUNmode_80MHz(void);
 
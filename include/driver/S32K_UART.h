@@ -67,6 +67,14 @@
 #define UART2_RX    PTA8       //PTD6 PTD17 PTA8
 #define UART2_TX    PTA9       //PTD7 PTE12 PTA9
 
+#define UART_NUM    3U
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+/* Callback executed from the receive interrupt for every char */
+typedef void (*uart_rx_callback)(uint8_t data, void *ctx);
+
 //==============================================================================
 //                         PUBLIC GLOBAL VARIABLES
 //==============================================================================
@@ -116,5 +124,14 @@ void UART_PutStr(LPUART_Type *base, uint8_t *str);
  */
 uint8_t UART_GetChar(LPUART_Type *base);
 
+/*
+ * @brief: Receive chars in the interrupt
+ * @param: base, LPUART0, LPUART1, LPUART2
+ * @param: callback, function called with every char (NULL: stop)
+ * @param: ctx, user pointer passed back to the callback
+ * @note: Do not mix with UART_GetChar() on the same port
+ */
+void UART_RxAttach(LPUART_Type *base, uart_rx_callback callback, void *ctx);
+
 
 #endif // __S32K_UART_H__
@@ -0,0 +1,131 @@
+/*
+ * =============================================================================
+ * File Name    : SYNTH.h
+ * Project      : S32K144_basic
+ * Module       : Wavetable Synthesizer (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Small polyphonic synthesizer for the PCM module. Every voice reads a
+ *   wavetable with a 32-bit phase accumulator and has its own ADSR envelope.
+ *   The voices are mixed in Q15 two at a time with the dual 16-bit multiply
+ *   accumulate of the Cortex-M4 (SMLAD), and the samples are rendered in
+ *   blocks from the PCM refill interrupt, so chords and alarms play with no
+ *   work in the main loop.
+ *
+ * Dependencies :
+ *   - PCM module
+ *
+ * Configuration :
+ *   - SYNTH_VOICES: voices playing at the same time (even)
+ *   - SYNTH_RATE_HZ: sample rate
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+#ifndef DRIVER_SYNTH_H_
+#define DRIVER_SYNTH_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define SYNTH_VOICES                   4U      // Mixed in pairs, must be even
+#define SYNTH_GAIN_SHIFT               2U      // log2(SYNTH_VOICES), mix headroom
+#define SYNTH_RATE_HZ                  PCM_RATE_MAX
+#define SYNTH_WAVE_BITS                8U      // 256 samples per wavetable
+#define SYNTH_WAVE_LEN                 (1U << SYNTH_WAVE_BITS)
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+/* Envelope of a note, times in ms and sustain level in Q15 */
+typedef struct {
+    uint16_t attack_ms;
+    uint16_t decay_ms;
+    int16_t sustain;
+    uint16_t release_ms;
+} synth_adsr;
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+extern const int16_t synth_sine[SYNTH_WAVE_LEN];
+extern const synth_adsr synth_piano;
+extern const synth_adsr synth_beep;
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Start the synthesizer, it streams silence until a note is played
+ * @param: wave: wavetable of SYNTH_WAVE_LEN Q15 samples, used by all voices
+ * @note: PCM_Init() must be called first
+ */
+void SYNTH_Start(const int16_t *wave);
+
+/*
+ * @brief: Stop the synthesizer and release the PCM output
+ */
+void SYNTH_Stop(void);
+
+/*
+ * @brief: Start a note on a free voice
+ * @param: freq_hz: frequency of the note
+ * @param: env: envelope, copied
+ * @return: voice number (0..SYNTH_VOICES-1), -1 if all voices are busy
+ * @note: A released voice is taken if no voice is idle
+ */
+int8_t SYNTH_NoteOn(uint16_t freq_hz, const synth_adsr *env);
+
+/*
+ * @brief: Release a note, the voice is free at the end of the release
+ * @param: voice: value returned by SYNTH_NoteOn(), others are ignored
+ */
+void SYNTH_NoteOff(uint8_t voice);
+
+/*
+ * @brief: Release all the notes
+ */
+void SYNTH_AllOff(void);
+
+/*
+ * @brief: Get the number of voices that are not idle
+ * @return: 0..SYNTH_VOICES
+ */
+uint8_t SYNTH_ActiveVoices(void);
+
+/*
+ * @brief: Measure the cost of the renderer
+ * @param: voices: voices to keep playing during the measure (0..SYNTH_VOICES)
+ * @return: CPU cycles per output sample
+ * @note: Renders in the caller, the synthesizer must be stopped
+ */
+uint32_t SYNTH_Benchmark(uint8_t voices);
+
+/*
+ * @brief: Test Routine, prints the benchmark and plays a chord and an alarm
+ */
+void Test_SYNTH(void);
+
+#endif /* DRIVER_SYNTH_H_ */
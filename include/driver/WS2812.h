@@ -0,0 +1,132 @@
+/*
+ * =============================================================================
+ * File Name    : WS2812.h
+ * Project      : S32K144_basic
+ * Module       : Addressable LED Strip Module (Header)
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Driver for WS2812 / SK6812 addressable RGB(W) LED strips. Each data bit is
+ *   expanded to three SPI bits (0 -> 100, 1 -> 110) with a table in flash and
+ *   the bitstream is sent by LPSPI1 fed by the eDMA. There are two transmit
+ *   buffers: WS2812_Show() encodes the frame into the one that is not being
+ *   sent, so the application can render while the strip is refreshed.
+ *
+ *   Timing with SCK = 8 MHz / 3 = 2.667 MHz:
+ *     - Bit time 1.125 us, T0H 375 ns, T1H 750 ns (WS2812B and SK6812 spec)
+ *     - 300 RGB LEDs: 8.1 ms per frame, about 120 fps maximum
+ *     - Encoding 300 LEDs takes about 0.1 ms of CPU time
+ *
+ * Dependencies :
+ *   - DMA driver (DMA_CH_WS2812, LPSPI1 TX request)
+ *   - LPSPI1 clocked from SOSCDIV2_CLK (8 MHz), SIRCDIV2_CLK in VLPR
+ *   - Clock notifier: a frame in flight is finished before a profile change
+ *
+ * Configuration :
+ *   - WS2812_PIN: data output, PTB16 (LPSPI1_SOUT)
+ *   - WS2812_MAX_LEDS: size of the buffers
+ *   - WS2812_BPP: 3 for RGB (WS2812), 4 for RGBW (SK6812)
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+#ifndef WS2812_H_
+#define WS2812_H_
+
+//==============================================================================
+//                               INCLUDES
+//==============================================================================
+#include "include.h"
+
+//==============================================================================
+//                         PUBLIC DEFINES AND MACROS
+//==============================================================================
+#define WS2812_PIN                     PTB16   // LPSPI1_SOUT (ALT3)
+#define WS2812_MAX_LEDS                320U
+#define WS2812_BPP                     3U      // Bytes per LED: 3 GRB, 4 GRBW
+#define WS2812_RESET_US                300U    // Latch time, newer WS2812B need > 280 us
+
+/* Colour as 0xWWRRGGBB */
+#define WS2812_RGB(r, g, b)            (((uint32_t)(r) << 16) | ((uint32_t)(g) << 8) | (uint32_t)(b))
+
+//==============================================================================
+//                        PUBLIC TYPES AND ENUMERATIONS
+//==============================================================================
+
+//==============================================================================
+//                         PUBLIC GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                        PUBLIC FUNCTION DECLARATIONS
+//==============================================================================
+
+/*
+ * @brief: Initialize LPSPI1, the DMA channel and the pin
+ * @param: count: number of LEDs of the strip (up to WS2812_MAX_LEDS)
+ * @note: All the LEDs are cleared and the strip is refreshed once
+ */
+void WS2812_Init(uint16_t count);
+
+/*
+ * @brief: Set the colour of a LED in the frame buffer
+ * @param: led: LED index (0 .. count - 1)
+ * @param: color: 0xWWRRGGBB, white is ignored unless WS2812_BPP is 4
+ * @note: The strip changes on the next WS2812_Show()
+ */
+void WS2812_SetPixel(uint16_t led, uint32_t color);
+
+/*
+ * @brief: Get the colour of a LED in the frame buffer
+ * @param: led: LED index
+ * @return: 0xWWRRGGBB
+ */
+uint32_t WS2812_GetPixel(uint16_t led);
+
+/*
+ * @brief: Set all the LEDs of the frame buffer
+ * @param: color: 0xWWRRGGBB
+ */
+void WS2812_Fill(uint32_t color);
+
+/*
+ * @brief: Send the frame buffer to the strip
+ * @note: Encodes the frame into the free transmit buffer and returns. If a
+ *        frame is being sent, the new one follows it (a frame still waiting
+ *        is replaced)
+ */
+void WS2812_Show(void);
+
+/*
+ * @brief: Check if a frame is being sent
+ * @return: true until the last frame given to WS2812_Show() has been sent
+ */
+bool WS2812_IsBusy(void);
+
+/*
+ * @brief: Get the number of frames sent
+ * @return: frames sent since WS2812_Init()
+ */
+uint32_t WS2812_GetFrames(void);
+
+/*
+ * @brief: Test Routine, rainbow at 60 fps and CPU time of the encoder
+ */
+void Test_WS2812(void);
+
+#endif /* WS2812_H_ */
@@ -46,10 +46,24 @@
 #include "S32K_SYSTICK.h"
 #include "S32K_WDOG.h"
 #include "S32K_NVIC.h"
+#include "S32K_DMA.h"
+#include "S32K_LPIT.h"
+#include "S32K_FTM.h"
+#include "S32K_LPTMR.h"
 
 #include "LED.h"
 #include "KEY.h"
+#include "KEYPAD.h"
 #include "BUZZ.h"
+#include "RTTTL.h"
+#include "PCM.h"
+#include "SYNTH.h"
+#include "LOGIC.h"
+#include "BAM.h"
+#include "LEDPAT.h"
+#include "LEDPWM.h"
+#include "WS2812.h"
+#include "DISPLAY.h"
 
 //==============================================================================
 //                         PUBLIC DEFINES AND MACROS
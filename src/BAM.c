@@ -0,0 +1,274 @@
+/*
+ * =============================================================================
+ * File Name    : BAM.c
+ * Project      : S32K144_basic
+ * Module       : Bit Angle Modulation Module
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Multi-channel software PWM based on Bit Angle Modulation. The duty of
+ *   every channel is split in BAM_BITS bit planes, and the plane k is shown
+ *   during a slot of BAM_BASE_TICKS << k timer ticks. Set/clear/toggle words
+ *   are precomputed per port, so one LPIT interrupt updates every channel of a
+ *   port with a single store per slot (PTOR), plus a resynchronization with
+ *   PSOR/PCOR at the start of each frame. The CPU cost only depends on the
+ *   number of ports in use, not on the number of channels (up to 32 per port).
+ *
+ * Dependencies :
+ *   - GPIO driver
+ *   - LPIT driver (channel LPIT_CH_BAM)
+ *
+ * Configuration :
+ *   - BAM_BITS: resolution of the duty (8 bits, 0..255)
+ *   - BAM_BASE_TICKS: length of the shortest slot, frame = 255 slots
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "BAM.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define BAM_PORT_NUM                   5U
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+typedef struct {
+    PTXn_e pin;                         // Output pin
+    bool active_low;                    // Polarity of the load
+    uint8_t duty;                       // Current duty
+} bam_channel;
+
+/* Words written to the port in every slot */
+typedef struct {
+    uint32_t set;                       // PSOR at the start of the frame
+    uint32_t clr;                       // PCOR at the start of the frame
+    uint32_t toggle[BAM_BITS];          // PTOR when entering slot k (k > 0)
+} bam_port_words;
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+static bam_channel bam_ch[BAM_MAX_CH];
+static uint8_t bam_ch_num;
+
+/* Output level of every plane, edited by BAM_SetDuty() */
+static uint32_t bam_plane[BAM_PORT_NUM][BAM_BITS];
+static uint32_t bam_mask[BAM_PORT_NUM];
+
+/* Words used by the interrupt and their next version */
+static bam_port_words bam_active[BAM_PORT_NUM];
+static bam_port_words bam_shadow[BAM_PORT_NUM];
+static volatile uint8_t bam_pending;    // Bit per port with new shadow words
+
+static uint8_t bam_ports[BAM_PORT_NUM]; // Ports in use
+static uint8_t bam_port_num;
+static uint8_t bam_slot;                // Slot being shown
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static void bam_port_build(uint8_t ptx);
+static void bam_slot_isr(void *ctx);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+uint8_t BAM_Attach(PTXn_e ptx_n, bool active_low)
+{
+    uint8_t ptx = PTX(ptx_n);
+    uint8_t ptn = PTn(ptx_n);
+    uint8_t ch;
+    uint8_t k;
+
+    if (bam_ch_num >= BAM_MAX_CH) {
+        return BAM_INVALID_CH;
+    }
+
+    ch = bam_ch_num++;
+    bam_ch[ch].pin = ptx_n;
+    bam_ch[ch].active_low = active_low;
+    bam_ch[ch].duty = 0U;
+
+    /* Off level in every plane */
+    GPIO_PinInit(ptx_n, GPO, active_low ? 1U : 0U);
+
+    if (bam_mask[ptx] == 0U) {
+        bam_ports[bam_port_num++] = ptx;
+    }
+    bam_mask[ptx] |= (1UL << ptn);
+    for (k = 0U; k < BAM_BITS; k++) {
+        if (active_low) {
+            bam_plane[ptx][k] |= (1UL << ptn);
+        }
+        else {
+            bam_plane[ptx][k] &= ~(1UL << ptn);
+        }
+    }
+    bam_port_build(ptx);
+
+    return ch;
+}
+
+
+void BAM_SetDuty(uint8_t ch, uint8_t duty)
+{
+    uint8_t ptx, ptn;
+    uint8_t level;
+    uint8_t k;
+
+    if (ch >= bam_ch_num) {
+        return;
+    }
+
+    ptx = PTX(bam_ch[ch].pin);
+    ptn = PTn(bam_ch[ch].pin);
+    bam_ch[ch].duty = duty;
+
+    /* Bit k of the duty is the level of the pin during slot k */
+    for (k = 0U; k < BAM_BITS; k++) {
+        level = ((duty >> k) & 1U) ^ (bam_ch[ch].active_low ? 1U : 0U);
+        if (level) {
+            bam_plane[ptx][k] |= (1UL << ptn);
+        }
+        else {
+            bam_plane[ptx][k] &= ~(1UL << ptn);
+        }
+    }
+    bam_port_build(ptx);
+}
+
+
+uint8_t BAM_GetDuty(uint8_t ch)
+{
+    return (ch < bam_ch_num) ? bam_ch[ch].duty : 0U;
+}
+
+
+void BAM_Start(void)
+{
+    bam_slot = BAM_BITS - 1U;
+
+    /* The first timeout enters slot 0, then the period of slot 1 is queued */
+    LPIT_ChannelInit(LPIT_CH_BAM, BAM_BASE_TICKS << bam_slot, bam_slot_isr, NULL);
+    LPIT_ChannelStart(LPIT_CH_BAM);
+    LPIT_SetPeriod(LPIT_CH_BAM, BAM_BASE_TICKS);
+}
+
+
+void BAM_Stop(void)
+{
+    LPIT_ChannelStop(LPIT_CH_BAM);
+}
+
+
+void Test_BAM(void)
+{
+    uint8_t ch[MAX_LED];
+    uint16_t phase = 0U;
+    uint16_t level;
+    uint8_t i;
+
+    /* Pins and polarities of the LED descriptor table */
+    for (i = 0U; i < MAX_LED; i++) {
+        ch[i] = BAM_Attach(LED_GetPin(i + 1U), LED_IsActiveLow(i + 1U));
+    }
+    BAM_Start();
+
+    while(1)
+    {
+        /* Triangle wave, shifted for every LED */
+        for (i = 0U; i < MAX_LED; i++) {
+            level = (uint16_t)((phase + (i * (510U / MAX_LED))) % 510U);
+            BAM_SetDuty(ch[i], (uint8_t)((level > BAM_DUTY_MAX) ? (510U - level) : level));
+        }
+        phase = (phase + 5U) % 510U;
+        delay(10);
+    }
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Compute the port words from the planes and queue them for the ISR
+ * @param: ptx: port index (0: PTA ... 4: PTE)
+ */
+static void bam_port_build(uint8_t ptx)
+{
+    uint32_t primask;
+    bam_port_words words;
+    uint8_t k;
+
+    words.set = bam_plane[ptx][0];
+    words.clr = bam_mask[ptx] & ~bam_plane[ptx][0];
+    words.toggle[0] = 0U;
+    for (k = 1U; k < BAM_BITS; k++) {
+        words.toggle[k] = bam_plane[ptx][k] ^ bam_plane[ptx][k - 1U];
+    }
+
+    /* The ISR must never see half of the words */
+    DisableInterruptsSave(primask);
+    bam_shadow[ptx] = words;
+    bam_pending |= (uint8_t)(1U << ptx);
+    RestoreInterrupts(primask);
+}
+
+/*
+ * @brief: Slot timeout, show the next plane on every port
+ */
+static void bam_slot_isr(void *ctx)
+{
+    GPIO_MemMapPtr gpio;
+    uint8_t ptx;
+    uint8_t i;
+
+    (void)ctx;
+
+    bam_slot = (bam_slot + 1U) & (BAM_BITS - 1U);
+
+    /* Period of the following slot, loaded by the timer at the next timeout */
+    LPIT_SetPeriod(LPIT_CH_BAM, BAM_BASE_TICKS << ((bam_slot + 1U) & (BAM_BITS - 1U)));
+
+    if (bam_slot == 0U) {
+        for (i = 0U; i < bam_port_num; i++) {
+            ptx = bam_ports[i];
+            if (bam_pending & (1U << ptx)) {
+                bam_pending &= (uint8_t)~(1U << ptx);
+                bam_active[ptx] = bam_shadow[ptx];
+            }
+            gpio = GPIOX[ptx];
+            gpio->PSOR = bam_active[ptx].set;
+            gpio->PCOR = bam_active[ptx].clr;
+        }
+    }
+    else {
+        for (i = 0U; i < bam_port_num; i++) {
+            ptx = bam_ports[i];
+            GPIOX[ptx]->PTOR = bam_active[ptx].toggle[bam_slot];
+        }
+    }
+}
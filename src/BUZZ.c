@@ -10,14 +10,20 @@
  * Description  :
  *   This file contains functions for controlling a buzzer to play simple songs.
  *   In this example, the buzzer will play a song in a predefined pattern.
+ *   Songs are played by a sequencer on the LPIT software tick, which starts
+ *   every note and calls an optional hook, so playing never blocks. A note is
+ *   one 16-bit word (note index and duration in ticks); the half period of
+ *   every note is computed at build time, so playback has no float or divide.
+ *   The tone is a 50% PWM on FTM0 ch1. The prescaler is chosen per note so
+ *   that the period keeps the most resolution (error below 0.02% up to
+ *   2 kHz), and silence is 0% duty with the counter running.
  *
  * Dependencies :
- *   - GPIO driver for buzzer control
- *   - Timer driver for generating delays
+ *   - FTM driver for the tone
+ *   - LPIT software tick for the note duration
  *
  * Configuration :
- *   - Buzzer connected to GPIO pin PTD16
- *   - Timer configured for delay generation
+ *   - Buzzer connected to PTD16 (FTM0_CH1)
  *
  * License :
  *   This file is part of a free software project released under the terms of
@@ -43,6 +49,29 @@
 //                         LOCAL DEFINES AND MACROS
 //==============================================================================
 #define MAX_NUM_NOTES                  8U
+#define BUZZ_PS_MAX                    7U
+#define BUZZ_ENV_HOLD_MAX              0x7FFFU     // CITER of the sustain step
+
+/* Frequency of the MIDI notes of octave -1 (C-1 .. B-1) in uHz */
+#define BUZZ_UHZ_0                     8175799ULL
+#define BUZZ_UHZ_1                     8661957ULL
+#define BUZZ_UHZ_2                     9177024ULL
+#define BUZZ_UHZ_3                     9722718ULL
+#define BUZZ_UHZ_4                     10300861ULL
+#define BUZZ_UHZ_5                     10913382ULL
+#define BUZZ_UHZ_6                     11562326ULL
+#define BUZZ_UHZ_7                     12249857ULL
+#define BUZZ_UHZ_8                     12978272ULL
+#define BUZZ_UHZ_9                     13750000ULL
+#define BUZZ_UHZ_10                    14567618ULL
+#define BUZZ_UHZ_11                    15433853ULL
+
+/* Half period in FTM ticks of MIDI note 12 * o + s, rounded */
+#define BUZZ_HALF(o, s)                ((uint16_t)(((uint64_t)FTM_CLK_HZ * 1000000ULL + (BUZZ_UHZ_##s << (o))) / \
+                                                    (2ULL * (BUZZ_UHZ_##s << (o)))))
+#define BUZZ_OCTAVE(o)                 BUZZ_HALF(o, 0), BUZZ_HALF(o, 1), BUZZ_HALF(o, 2), BUZZ_HALF(o, 3), \
+                                       BUZZ_HALF(o, 4), BUZZ_HALF(o, 5), BUZZ_HALF(o, 6), BUZZ_HALF(o, 7), \
+                                       BUZZ_HALF(o, 8), BUZZ_HALF(o, 9), BUZZ_HALF(o, 10), BUZZ_HALF(o, 11)
 
 
 //==============================================================================
@@ -52,73 +81,114 @@
 //==============================================================================
 //                           GLOBAL VARIABLES
 //==============================================================================
-/* List the frequencies according to the simple notation */
-const uint16_t tune[] = {
-    M3, M3, M4, M5,
-    M5, M4, M3, M2,
-    M1, M1, M2, M3,
-    M3, M2, M2,
-    M3, M3, M4, M5,
-    M5, M4, M3, M2,
-    M1, M1, M2, M3,
-    M2, M1, M1,
-    M2, M2, M3, M1,
-    M2, M3, M4, M3, M1,
-    M2, M3, M4, M3, M2,
-    M1, M2, D5, D0,
-    M3, M3, M4, M5,
-    M5, M4, M3, M4, M2,
-    M1, M1, M2, M3,
-    M2, M1, M1
+/* Notes of the song, 2 bytes per note */
+const buzz_note song[] = {
+    BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M4, WHOLE), BUZZ_NOTE(M5, WHOLE),
+    BUZZ_NOTE(M5, WHOLE), BUZZ_NOTE(M4, WHOLE), BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M2, WHOLE),
+    BUZZ_NOTE(M1, WHOLE), BUZZ_NOTE(M1, WHOLE), BUZZ_NOTE(M2, WHOLE), BUZZ_NOTE(M3, WHOLE),
+    BUZZ_NOTE(M3, WHOLE + HALF), BUZZ_NOTE(M2, HALF), BUZZ_NOTE(M2, 2U * WHOLE),
+    BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M4, WHOLE), BUZZ_NOTE(M5, WHOLE),
+    BUZZ_NOTE(M5, WHOLE), BUZZ_NOTE(M4, WHOLE), BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M2, WHOLE),
+    BUZZ_NOTE(M1, WHOLE), BUZZ_NOTE(M1, WHOLE), BUZZ_NOTE(M2, WHOLE), BUZZ_NOTE(M3, WHOLE),
+    BUZZ_NOTE(M2, WHOLE + HALF), BUZZ_NOTE(M1, HALF), BUZZ_NOTE(M1, 2U * WHOLE),
+    BUZZ_NOTE(M2, WHOLE), BUZZ_NOTE(M2, WHOLE), BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M1, WHOLE),
+    BUZZ_NOTE(M2, WHOLE), BUZZ_NOTE(M3, HALF), BUZZ_NOTE(M4, HALF), BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M1, WHOLE),
+    BUZZ_NOTE(M2, WHOLE), BUZZ_NOTE(M3, HALF), BUZZ_NOTE(M4, HALF), BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M2, WHOLE),
+    BUZZ_NOTE(M1, WHOLE), BUZZ_NOTE(M2, WHOLE), BUZZ_NOTE(D5, WHOLE), BUZZ_NOTE(D0, WHOLE),
+    BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M4, WHOLE), BUZZ_NOTE(M5, WHOLE),
+    BUZZ_NOTE(M5, WHOLE), BUZZ_NOTE(M4, WHOLE), BUZZ_NOTE(M3, WHOLE), BUZZ_NOTE(M4, HALF), BUZZ_NOTE(M2, HALF),
+    BUZZ_NOTE(M1, WHOLE), BUZZ_NOTE(M1, WHOLE), BUZZ_NOTE(M2, WHOLE), BUZZ_NOTE(M3, WHOLE),
+    BUZZ_NOTE(M2, WHOLE + HALF), BUZZ_NOTE(M1, HALF), BUZZ_NOTE(M1, 2U * WHOLE),
+    BUZZ_NOTE(D0, 4U * WHOLE),
+    BUZZ_END
 };
 
-/* List the beats according to the simple notation */
-const float durt[] = {
-    1,    1,    1,    1,
-    1,    1,    1,    1,
-    1,    1,    1,    1,
-  1.5,  0.5,    2,
-    1,    1,    1,    1,
-    1,    1,    1,    1,
-    1,    1,    1,    1,
-  1.5,  0.5,    2,
-    1,    1,    1,    1,
-    1,  0.5,  0.5,    1,    1,
-    1,  0.5,  0.5,    1,    1,
-    1,    1,    1,    1,
-    1,    1,    1,    1,
-    1,    1,    1,  0.5,  0.5,
-    1,    1,    1,    1,
-  1.5,  0.5,    2,
-};
+/* Soft onset and release, for alarms and the song */
+const buzz_adsr buzz_soft = { 8U, 60U, 160U, 40U };
 
 //==============================================================================
 //                          STATIC VARIABLES
 //==============================================================================
+static uint8_t buzz_ch;
+
+/*
+ * Half period of every note index, computed by the compiler. The lowest note
+ * (C3, 61156 ticks) still fits in MOD with no prescaler.
+ */
+static const uint16_t buzz_half[64] = {
+    0U,                                                 // Rest
+    BUZZ_OCTAVE(4), BUZZ_OCTAVE(5), BUZZ_OCTAVE(6), BUZZ_OCTAVE(7), BUZZ_OCTAVE(8),
+    BUZZ_HALF(9, 0), BUZZ_HALF(9, 1), BUZZ_HALF(9, 2)
+};
+
+/* Sequencer, notes come from the song first and then from the queue */
+static const buzz_note *buzz_song = NULL;
+static buzz_note buzz_queue[BUZZ_QUEUE_LEN];
+static volatile uint8_t buzz_head = 0U;                 // Written by BUZZ_Queue()
+static volatile uint8_t buzz_tail = 0U;                 // Written by the tick
+static uint16_t buzz_left = 0U;                         // Ticks left of the note
+static volatile bool buzz_busy = false;
+static buzz_note_hook buzz_hook = NULL;
+static void *buzz_hook_ctx = NULL;
+static buzz_done_callback buzz_done = NULL;
+static void *buzz_done_ctx = NULL;
+
+/*
+ * Envelope. The levels of attack, decay and release are computed once by
+ * BUZZ_SetEnvelope() in 1/256 steps, so every note scales them to its period
+ * with a multiply and a shift, and the DMA writes them to CnV: attack/decay,
+ * sustain hold, release.
+ */
+static bool buzz_env_on = false;
+static uint8_t buzz_volume = 255U;
+static uint16_t buzz_env_level[BUZZ_ENV_LEN];           // Of 256
+static uint16_t buzz_env_release[BUZZ_ENV_LEN];         // Of 256, from 1 down to 0
+static uint16_t buzz_env_ad_len = 0U;
+static uint16_t buzz_env_sustain = 256U;
+static uint16_t buzz_env_release_ms = 0U;
+static uint16_t buzz_env_ad[BUZZ_ENV_LEN];              // CnV words, read by the DMA
+static uint16_t buzz_env_r[BUZZ_ENV_LEN];
+static uint16_t buzz_env_hold;
+static dma_tcd buzz_env_tcd[3];
 
 //==============================================================================
 //                      STATIC FUNCTION DECLARATIONS
 //==============================================================================
-static void tone (uint32_t frecuency, uint32_t duration);
+static void buzz_tone_end(void *ctx);
+static void buzz_start(void);
+static bool buzz_next(void);
+static void buzz_tick(void *ctx);
+static void buzz_led_hook(buzz_note note, void *ctx);
+static void buzz_sound(uint8_t ps, uint16_t mod, uint16_t half, uint32_t duration_ms);
+static void buzz_env_stop(void);
+static void buzz_env_wait(void *ctx);
 
 //==============================================================================
 //                       PUBLIC FUNCTION DEFINITIONS
 //==============================================================================
 void BUZZ_Init(void)
 {
-    GPIO_PinInit(PTD16, GPO, 0);         /* Configure buzz ports */
-    LED_Init();
+    uint8_t ftm;
+
+    /* Buzzer pin on FTM0 ch1, silent until the first tone */
+    FTM_Init(BUZZ_FTM, 0U, 0xFFFFU);
+    FTM_PwmInit(BUZZ_PIN, false, &ftm, &buzz_ch);
+    LEDPAT_Init();
+
+    /* Envelope steps on every LPIT tick */
+    DMA_Init();
+    DMA_ChannelMux(DMA_CH_BUZZ_ENV, EDMA_REQ_DMAMUX_ALWAYS_ENABLED1, true);
 }
 
 void BUZZ_MainTask(void)
 {
-    const uint16_t length = sizeof (tune)/ sizeof (tune[0]);
-    for (uint16_t i = 0; i < length; i++) {
-        LED_Reverse(3);
-        tone(tune[i], (500*durt[i]));
-        LED_Reverse(3);
+    /* The song ends with a 2 s rest, then it starts again */
+    if (!BUZZ_IsBusy()) {
+        /* Flash LED3 on every note, handled by the pattern engine */
+        BUZZ_SetNoteHook(buzz_led_hook, NULL);
+        BUZZ_SetEnvelope(&buzz_soft);
+        BUZZ_Play(song, NULL, NULL);
     }
-    delay(2000);
 }
 
 void BUZZ_playNote(char note, uint16_t duration)
@@ -128,39 +198,357 @@ void BUZZ_playNote(char note, uint16_t duration)
 
     for (uint16_t i = 0; i < MAX_NUM_NOTES; i++) {
         if (names[i] == note) {
-            for (uint32_t j = 0; j < duration * 1000; j += tones[i] * 2 ) {
-                BUZZ_OFF();
-                systime.delay_us(tones[i]);
-                BUZZ_ON();
-                systime.delay_us(tones[i]);
-                BUZZ_OFF();
-            }
+            /* tones[] holds the half period in us */
+            BUZZ_Tone((uint16_t)(500000U / tones[i]), duration);
             /* break the loop */
             break;
         }
     }
 }
 
+void BUZZ_Tone(uint16_t freq_hz, uint16_t duration_ms)
+{
+    uint32_t ticks;
+    uint8_t ps = 0U;
+
+    LPIT_TickDetach(buzz_tone_end, NULL);
+    LPIT_TickDetach(buzz_env_wait, NULL);
+
+    if (freq_hz == 0U) {
+        BUZZ_NoTone();
+        return;
+    }
+
+    /* Smallest prescaler that fits the period in the 16-bit counter */
+    while (ps < BUZZ_PS_MAX && ((FTM_CLK_HZ >> ps) / freq_hz) > 0x10000U) {
+        ps++;
+    }
+    ticks = ((FTM_CLK_HZ >> ps) + (freq_hz / 2U)) / freq_hz;
+    ticks = (ticks > 0x10000U) ? 0x10000U : ticks;
+
+    buzz_sound(ps, (uint16_t)(ticks - 1U), (uint16_t)(ticks / 2U), duration_ms);
+
+    if (duration_ms != 0U) {
+        LPIT_TickAttach(buzz_tone_end, NULL, duration_ms);
+    }
+    else if (buzz_env_on) {
+        /* The LPIT tick paces the envelope, keep it running */
+        LPIT_TickAttach(buzz_env_wait, NULL, 1U);
+    }
+}
+
+void BUZZ_NoTone(void)
+{
+    LPIT_TickDetach(buzz_tone_end, NULL);
+    LPIT_TickDetach(buzz_env_wait, NULL);
+    buzz_env_stop();
+
+    /* 0% duty from the end of the current period */
+    FTMX[BUZZ_FTM]->CONTROLS[buzz_ch].CnV = 0U;
+}
+
+void BUZZ_Play(const buzz_note *notes, buzz_done_callback done, void *ctx)
+{
+    BUZZ_Stop();
+
+    buzz_song = notes;
+    buzz_done = done;
+    buzz_done_ctx = ctx;
+    buzz_start();
+}
+
+bool BUZZ_Queue(buzz_note note)
+{
+    uint8_t next = (uint8_t)((buzz_head + 1U) % BUZZ_QUEUE_LEN);
+
+    if (next == buzz_tail || BUZZ_NOTE_TICKS(note) == 0U) {
+        return false;
+    }
+
+    buzz_queue[buzz_head] = note;
+    buzz_head = next;
+    buzz_start();
+
+    return true;
+}
+
+void BUZZ_Stop(void)
+{
+    /* Without the tick nothing else touches the sequencer */
+    LPIT_TickDetach(buzz_tick, NULL);
+    buzz_song = NULL;
+    buzz_tail = buzz_head;
+    buzz_busy = false;
+
+    BUZZ_NoTone();
+}
+
+bool BUZZ_IsBusy(void)
+{
+    return buzz_busy;
+}
+
+void BUZZ_SetNoteHook(buzz_note_hook hook, void *ctx)
+{
+    uint32_t primask;
+
+    DisableInterruptsSave(primask);
+    buzz_hook = hook;
+    buzz_hook_ctx = ctx;
+    RestoreInterrupts(primask);
+}
+
+void BUZZ_SetEnvelope(const buzz_adsr *adsr)
+{
+    uint32_t primask;
+    uint16_t attack, decay, release, sustain;
+
+    if (adsr == NULL) {
+        buzz_env_on = false;
+        return;
+    }
+
+    attack = (adsr->attack_ms < BUZZ_ENV_LEN) ? adsr->attack_ms : BUZZ_ENV_LEN;
+    decay = (adsr->decay_ms < (BUZZ_ENV_LEN - attack)) ? adsr->decay_ms : (BUZZ_ENV_LEN - attack);
+    release = (adsr->release_ms < BUZZ_ENV_LEN) ? adsr->release_ms : BUZZ_ENV_LEN;
+    sustain = (uint16_t)(adsr->sustain + (adsr->sustain >> 7));     // 255 -> 256
+
+    /* The tables are read when a note starts, from the tick interrupt */
+    DisableInterruptsSave(primask);
+    for (uint16_t i = 0; i < attack; i++) {
+        buzz_env_level[i] = (uint16_t)(256U * (i + 1U) / attack);
+    }
+    for (uint16_t i = 0; i < decay; i++) {
+        buzz_env_level[attack + i] = (uint16_t)(256U - (256U - sustain) * (i + 1U) / decay);
+    }
+    for (uint16_t i = 0; i < release; i++) {
+        buzz_env_release[i] = (uint16_t)(256U * (release - 1U - i) / release);
+    }
+    buzz_env_ad_len = attack + decay;
+    buzz_env_sustain = sustain;
+    buzz_env_release_ms = release;
+    buzz_env_on = true;
+    RestoreInterrupts(primask);
+}
+
+void BUZZ_SetVolume(uint8_t volume)
+{
+    buzz_volume = volume;
+}
+
 //==============================================================================
 //                       STATIC FUNCTION DEFINITIONS
 //==============================================================================
 
 /*
- * @brief: Play a note with the buzzer
- * @param: frecuency: frecuency of the note
- * @param: duration: duration time in us
+ * @brief: End of the tone duration
+ * @param: ctx: not used
+ */
+static void buzz_tone_end(void *ctx)
+{
+    (void)ctx;
+
+    BUZZ_NoTone();
+}
+
+/*
+ * @brief: Start the sequencer if it is idle and there is a note to play
+ * @note: While idle the tick is detached, so only the caller runs here. A
+ *        note queued while busy is always seen by the tick, which only goes
+ *        idle after checking the queue.
+ */
+static void buzz_start(void)
+{
+    if (buzz_busy) {
+        return;
+    }
+
+    /* A BUZZ_Tone() duration must not cut the first note */
+    LPIT_TickDetach(buzz_tone_end, NULL);
+    if (buzz_next()) {
+        buzz_busy = true;
+        LPIT_TickAttach(buzz_tick, NULL, BUZZ_TICK_MS);
+    }
+}
+
+/*
+ * @brief: Start the next note of the song or the queue
+ * @return: false if there are no more notes
+ */
+static bool buzz_next(void)
+{
+    buzz_note note;
+    uint16_t half;
+
+    if (buzz_song != NULL && BUZZ_NOTE_TICKS(*buzz_song) != 0U) {
+        note = *buzz_song++;
+    }
+    else if (buzz_tail != buzz_head) {
+        buzz_song = NULL;
+        note = buzz_queue[buzz_tail];
+        buzz_tail = (uint8_t)((buzz_tail + 1U) % BUZZ_QUEUE_LEN);
+    }
+    else {
+        buzz_song = NULL;
+        return false;
+    }
+
+    /* Table lookups only, no divide while playing */
+    half = buzz_half[BUZZ_NOTE_INDEX(note)];
+    if (half != 0U) {
+        buzz_sound(0U, (uint16_t)(2U * half - 1U), half, (uint32_t)BUZZ_NOTE_TICKS(note) * BUZZ_TICK_MS);
+    }
+    else {
+        buzz_env_stop();
+        FTMX[BUZZ_FTM]->CONTROLS[buzz_ch].CnV = 0U;
+    }
+    buzz_left = BUZZ_NOTE_TICKS(note);
+
+    if (buzz_hook != NULL) {
+        buzz_hook(note, buzz_hook_ctx);
+    }
+
+    return true;
+}
+
+/*
+ * @brief: Sequencer tick, every BUZZ_TICK_MS while a note plays
+ * @param: ctx: not used
+ */
+static void buzz_tick(void *ctx)
+{
+    (void)ctx;
+
+    if (--buzz_left != 0U || buzz_next()) {
+        return;
+    }
+
+    /* End of the song */
+    BUZZ_NoTone();
+    LPIT_TickDetach(buzz_tick, NULL);
+    buzz_busy = false;
+
+    if (buzz_done != NULL) {
+        buzz_done(buzz_done_ctx);
+    }
+}
+
+/*
+ * @brief: Note hook of BUZZ_MainTask(), flashes LED3
+ * @param: note: note that starts
+ * @param: ctx: not used
  */
-static void tone (uint32_t frecuency, uint32_t duration)
+static void buzz_led_hook(buzz_note note, void *ctx)
 {
-    uint32_t ustime = 1000000 / frecuency;
-    uint32_t dur = systime.get_time_ms();
+    (void)ctx;
+
+    if (BUZZ_NOTE_INDEX(note) != 0U) {
+        LEDPAT_Start(3U, ledpat_flash, 0U);
+    }
+}
+
+/*
+ * @brief: Start a tone with the volume and the envelope
+ * @param: ps: prescaler of the period
+ * @param: mod: period - 1, in ticks
+ * @param: half: 50% duty in ticks, the duty at full level
+ * @param: duration_ms: length of the envelope, 0 to hold the sustain level
+ */
+static void buzz_sound(uint8_t ps, uint16_t mod, uint16_t half, uint32_t duration_ms)
+{
+    uint32_t peak = (uint32_t)half * (buzz_volume + (buzz_volume >> 7U));     // CnV * 256 at full level
+    uint32_t ad_len = buzz_env_ad_len;
+    uint32_t r_len = 0U;
+    uint32_t hold = 1U;
+    uint32_t level = buzz_env_sustain;
+    uint8_t n = 0U;
+
+    buzz_env_stop();
+
+    if (!buzz_env_on) {
+        FTM_PwmPeriod(BUZZ_FTM, buzz_ch, ps, mod, (uint16_t)(peak >> 8U));
+        return;
+    }
+
+    /* A short note keeps up to half of it for the release, which is cut at the end */
+    if (duration_ms != 0U) {
+        r_len = (buzz_env_release_ms < (duration_ms >> 1U)) ? buzz_env_release_ms : (duration_ms >> 1U);
+        ad_len = (ad_len < duration_ms - r_len) ? ad_len : duration_ms - r_len;
+        hold = duration_ms - r_len - ad_len;
+        hold = (hold > BUZZ_ENV_HOLD_MAX) ? BUZZ_ENV_HOLD_MAX : hold;
+    }
+    if (ad_len != 0U) {
+        level = buzz_env_level[ad_len - 1U];
+    }
+
+    /* Levels to CnV words of this period, multiply and shift only */
+    for (uint32_t i = 0; i < ad_len; i++) {
+        buzz_env_ad[i] = (uint16_t)((peak * buzz_env_level[i]) >> 16U);
+    }
+    buzz_env_hold = (uint16_t)((peak * level) >> 16U);
+    for (uint32_t i = 0; i < r_len; i++) {
+        buzz_env_r[i] = (uint16_t)(((uint32_t)buzz_env_hold * buzz_env_release[i]) >> 8U);
+    }
 
-    while ((systime.get_time_ms() - dur) < duration) {
-        BUZZ_OFF();
-        systime.delay_us(ustime/2);
-        BUZZ_ON();
-        systime.delay_us(ustime/2);
-        BUZZ_OFF();
+    /* Steps of 1 word per tick: attack/decay, sustain, release */
+    if (ad_len != 0U) {
+        buzz_env_tcd[n].saddr = (uint32_t)buzz_env_ad;
+        buzz_env_tcd[n].soff = (int16_t)sizeof(uint16_t);
+        buzz_env_tcd[n].citer = (uint16_t)ad_len;
+        n++;
     }
+    if (hold != 0U) {
+        buzz_env_tcd[n].saddr = (uint32_t)&buzz_env_hold;
+        buzz_env_tcd[n].soff = 0;
+        buzz_env_tcd[n].citer = (uint16_t)hold;
+        n++;
+    }
+    if (r_len != 0U) {
+        buzz_env_tcd[n].saddr = (uint32_t)buzz_env_r;
+        buzz_env_tcd[n].soff = (int16_t)sizeof(uint16_t);
+        buzz_env_tcd[n].citer = (uint16_t)r_len;
+        n++;
+    }
+    for (uint8_t i = 0; i < n; i++) {
+        buzz_env_tcd[i].attr = DMA_ATTR(DMA_SIZE_16BIT, DMA_SIZE_16BIT);
+        buzz_env_tcd[i].nbytes = sizeof(uint16_t);
+        buzz_env_tcd[i].slast = 0;
+        buzz_env_tcd[i].daddr = (uint32_t)&FTMX[BUZZ_FTM]->CONTROLS[buzz_ch].CnV;
+        buzz_env_tcd[i].doff = 0;
+        buzz_env_tcd[i].biter = buzz_env_tcd[i].citer;
+        if (i + 1U < n) {
+            buzz_env_tcd[i].dlast_sga = (int32_t)&buzz_env_tcd[i + 1U];
+            buzz_env_tcd[i].csr = DMA_TCD_CSR_ESG_MASK;
+        }
+        else {
+            buzz_env_tcd[i].dlast_sga = 0;
+            buzz_env_tcd[i].csr = DMA_TCD_CSR_DREQ_MASK;
+        }
+    }
+
+    FTM_PwmPeriod(BUZZ_FTM, buzz_ch, ps, mod, (ad_len != 0U) ? buzz_env_ad[0] : buzz_env_hold);
+    DMA_TcdLoad(DMA_CH_BUZZ_ENV, &buzz_env_tcd[0]);
+    DMA_ChannelStart(DMA_CH_BUZZ_ENV);
 }
 
+/*
+ * @brief: Stop the envelope steps, CnV keeps the last value
+ */
+static void buzz_env_stop(void)
+{
+    DMA_ChannelStop(DMA_CH_BUZZ_ENV);
+    while (DMA->TCD[DMA_CH_BUZZ_ENV].CSR & DMA_TCD_CSR_ACTIVE_MASK);
+}
+
+/*
+ * @brief: Keeps the LPIT tick running until the envelope of a tone is over
+ * @param: ctx: not used
+ */
+static void buzz_env_wait(void *ctx)
+{
+    (void)ctx;
+
+    if ((DMA->ERQ & (1UL << DMA_CH_BUZZ_ENV)) == 0U) {
+        LPIT_TickDetach(buzz_env_wait, NULL);
+    }
+}
@@ -0,0 +1,391 @@
+/*
+ * =============================================================================
+ * File Name    : DISPLAY.c
+ * Project      : S32K144_basic
+ * Module       : Multiplexed Display Module
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   FTM2 counts one row time. Its channels only request DMA:
+ *     - ch0 (CnV = 0): the ROW channel runs one descriptor of a ring, one per
+ *       row, that writes {PCOR, PSOR} of the port (old row off, new segments
+ *       and row on). Its major loop links to the ON channel, which copies the
+ *       on-time of the row to ch1 CnV.
+ *     - ch1 (CnV = on-time): the BLANK channel turns all the rows off.
+ *
+ *   There are two descriptor rings, one per word buffer. DISPLAY_Show() fills
+ *   the idle buffer and links the last descriptor of the running ring to it.
+ *
+ * Dependencies :
+ *   - FTM, DMA drivers
+ *
+ * Configuration :
+ *   - See DISPLAY.h
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "DISPLAY.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define DISPLAY_ROW_TICKS              ((FTM_CLK_HZ / 1000000U) * DISPLAY_ROW_US)
+#define DISPLAY_ON_MAX                 (DISPLAY_ROW_TICKS - (FTM_CLK_HZ / 1000000U) * DISPLAY_BLANK_US)
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+const uint8_t display_hex[16] = {
+    0x3FU, 0x06U, 0x5BU, 0x4FU, 0x66U, 0x6DU, 0x7DU, 0x07U,
+    0x7FU, 0x6FU, 0x77U, 0x7CU, 0x39U, 0x5EU, 0x79U, 0x71U
+};
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+static display_cfg display;
+static uint8_t display_port;
+static uint32_t display_row_pins[DISPLAY_MAX_ROWS];
+static uint32_t display_seg_pins[DISPLAY_MAX_SEGS];
+static uint32_t display_row_mask;
+static uint32_t display_all_mask;
+static uint32_t display_low_mask;                       // Pins active low
+static uint32_t display_blank;                          // Rows off, for PSOR or PCOR
+
+static uint16_t display_fb[DISPLAY_MAX_ROWS];
+static uint8_t display_level[DISPLAY_MAX_ROWS];
+static uint16_t display_on[DISPLAY_MAX_ROWS];           // Copied to ch1 CnV
+
+/* {PCOR, PSOR} per row, one spare row so that the rings never look alike */
+static uint32_t display_words[2][DISPLAY_MAX_ROWS + 1U][2];
+static dma_tcd display_ring[2][DISPLAY_MAX_ROWS];
+static uint8_t display_front = 0U;                      // Ring shown, or about to
+static bool display_running = false;
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static void display_encode(uint8_t buff);
+static bool display_in_ring(uint8_t buff);
+static void display_pins_off(void);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+bool DISPLAY_Init(const display_cfg *cfg)
+{
+    uint8_t i, b;
+
+    if (cfg->nrows == 0U || cfg->nrows > DISPLAY_MAX_ROWS || cfg->nsegs > DISPLAY_MAX_SEGS) {
+        return false;
+    }
+
+    for (i = 0U; i < cfg->nrows; i++) {
+        if (PTX(cfg->rows[i]) != PTX(cfg->rows[0])) {
+            return false;
+        }
+    }
+    for (i = 0U; i < cfg->nsegs; i++) {
+        if (PTX(cfg->segs[i]) != PTX(cfg->rows[0])) {
+            return false;
+        }
+    }
+
+    DISPLAY_Stop();
+
+    display = *cfg;
+    display_port = PTX(cfg->rows[0]);
+    display_row_mask = 0U;
+    display_low_mask = 0U;
+
+    for (i = 0U; i < display.nrows; i++) {
+        display_row_pins[i] = 1UL << PTn(display.rows[i]);
+        display_row_mask |= display_row_pins[i];
+        display_level[i] = 255U;
+        display_on[i] = (uint16_t)DISPLAY_ON_MAX;
+        display_fb[i] = 0U;
+    }
+    display_all_mask = display_row_mask;
+    for (i = 0U; i < display.nsegs; i++) {
+        display_seg_pins[i] = 1UL << PTn(display.segs[i]);
+        display_all_mask |= display_seg_pins[i];
+    }
+
+    if (display.rows_low) {
+        display_low_mask |= display_row_mask;
+    }
+    if (display.segs_low) {
+        display_low_mask |= display_all_mask & ~display_row_mask;
+    }
+    display_blank = display_row_mask;
+
+    for (i = 0U; i < display.nrows; i++) {
+        GPIO_PinInit(display.rows[i], GPO, display.rows_low ? 1U : 0U);
+    }
+    for (i = 0U; i < display.nsegs; i++) {
+        GPIO_PinInit(display.segs[i], GPO, display.segs_low ? 1U : 0U);
+    }
+
+    /* Each ring loops on itself until DISPLAY_Show() links it to the other */
+    for (b = 0U; b < 2U; b++) {
+        for (i = 0U; i < display.nrows; i++) {
+            display_ring[b][i].saddr = (uint32_t)display_words[b][i];
+            display_ring[b][i].soff = sizeof(uint32_t);
+            display_ring[b][i].attr = DMA_ATTR(DMA_SIZE_32BIT, DMA_SIZE_32BIT);
+            display_ring[b][i].nbytes = 2U * sizeof(uint32_t);
+            display_ring[b][i].slast = 0;
+            display_ring[b][i].daddr = (uint32_t)&GPIOX[display_port]->PCOR;
+            display_ring[b][i].doff = -(int16_t)sizeof(uint32_t);      // PCOR, then PSOR
+            display_ring[b][i].citer = 1U;
+            display_ring[b][i].dlast_sga = (int32_t)&display_ring[b][(i + 1U) % display.nrows];
+            display_ring[b][i].csr = DMA_TCD_CSR_ESG_MASK | DMA_TCD_CSR_MAJORELINK_MASK
+                                   | DMA_TCD_CSR_MAJORLINKCH(DMA_CH_DISPLAY_ON);
+            display_ring[b][i].biter = 1U;
+        }
+        display_encode(b);
+    }
+    display_front = 0U;
+
+    return true;
+}
+
+
+void DISPLAY_Start(void)
+{
+    FTM_Type *base = FTMX[DISPLAY_FTM];
+    dma_tcd tcd;
+
+    if (display_running || display.nrows == 0U) {
+        return;
+    }
+
+    DMA_Init();
+
+    /* ON: on-time of the row, started by the link of the ROW channel */
+    tcd.saddr = (uint32_t)display_on;
+    tcd.soff = sizeof(uint16_t);
+    tcd.attr = DMA_ATTR(DMA_SIZE_16BIT, DMA_SIZE_16BIT);
+    tcd.nbytes = sizeof(uint16_t);
+    tcd.slast = -(int32_t)(display.nrows * sizeof(uint16_t));
+    tcd.daddr = (uint32_t)&base->CONTROLS[1].CnV;
+    tcd.doff = 0;
+    tcd.citer = display.nrows;
+    tcd.dlast_sga = 0;
+    tcd.csr = 0U;
+    tcd.biter = display.nrows;
+    DMA_TcdLoad(DMA_CH_DISPLAY_ON, &tcd);
+
+    /* BLANK: all rows off */
+    tcd.saddr = (uint32_t)&display_blank;
+    tcd.soff = 0;
+    tcd.attr = DMA_ATTR(DMA_SIZE_32BIT, DMA_SIZE_32BIT);
+    tcd.nbytes = sizeof(uint32_t);
+    tcd.slast = 0;
+    tcd.daddr = display.rows_low ? (uint32_t)&GPIOX[display_port]->PSOR
+                                 : (uint32_t)&GPIOX[display_port]->PCOR;
+    tcd.citer = 1U;
+    tcd.biter = 1U;
+    DMA_TcdLoad(DMA_CH_DISPLAY_BLANK, &tcd);
+
+    DMA_TcdLoad(DMA_CH_DISPLAY_ROW, &display_ring[display_front][0]);
+
+    DMA_ChannelMux(DMA_CH_DISPLAY_ROW, EDMA_REQ_FTM2_CHANNEL_0, false);
+    DMA_ChannelMux(DMA_CH_DISPLAY_BLANK, EDMA_REQ_FTM2_CHANNEL_1, false);
+    DMA_ChannelStart(DMA_CH_DISPLAY_ROW);
+    DMA_ChannelStart(DMA_CH_DISPLAY_BLANK);
+
+    /* Software compares (no pins) requesting DMA */
+    FTM_Init(DISPLAY_FTM, 0U, (uint16_t)(DISPLAY_ROW_TICKS - 1U));
+    base->CONTROLS[0].CnV = 0U;
+    base->CONTROLS[1].CnV = display_on[0];
+    base->CONTROLS[0].CnSC = FTM_CnSC_MSA_MASK | FTM_CnSC_CHIE_MASK | FTM_CnSC_DMA_MASK;
+    base->CONTROLS[1].CnSC = FTM_CnSC_MSA_MASK | FTM_CnSC_CHIE_MASK | FTM_CnSC_DMA_MASK;
+
+    display_running = true;
+}
+
+
+void DISPLAY_Stop(void)
+{
+    if (!display_running) {
+        return;
+    }
+
+    FTMX[DISPLAY_FTM]->SC = 0U;
+    FTMX[DISPLAY_FTM]->CONTROLS[0].CnSC = 0U;
+    FTMX[DISPLAY_FTM]->CONTROLS[1].CnSC = 0U;
+    DMA_ChannelStop(DMA_CH_DISPLAY_ROW);
+    DMA_ChannelStop(DMA_CH_DISPLAY_BLANK);
+    while (DMA->TCD[DMA_CH_DISPLAY_ON].CSR & DMA_TCD_CSR_ACTIVE_MASK);
+
+    /* The ring restarts from row 0, with the ON channel */
+    display_ring[display_front ^ 1U][display.nrows - 1U].dlast_sga = (int32_t)&display_ring[display_front ^ 1U][0];
+    display_ring[display_front][display.nrows - 1U].dlast_sga = (int32_t)&display_ring[display_front][0];
+
+    display_pins_off();
+    display_running = false;
+}
+
+
+void DISPLAY_SetRow(uint8_t row, uint16_t segs)
+{
+    if (row < display.nrows) {
+        display_fb[row] = segs;
+    }
+}
+
+
+void DISPLAY_Clear(void)
+{
+    uint8_t i;
+
+    for (i = 0U; i < DISPLAY_MAX_ROWS; i++) {
+        display_fb[i] = 0U;
+    }
+}
+
+
+void DISPLAY_Show(void)
+{
+    uint8_t back = display_front ^ 1U;
+
+    if (display.nrows == 0U) {
+        return;
+    }
+
+    /* The last switch must have happened before the idle ring is rewritten */
+    while (display_running && !display_in_ring(display_front));
+
+    display_ring[back][display.nrows - 1U].dlast_sga = (int32_t)&display_ring[back][0];
+    display_encode(back);
+
+    /* Single store, the DMA takes it at the end of a frame */
+    display_ring[display_front][display.nrows - 1U].dlast_sga = (int32_t)&display_ring[back][0];
+    display_front = back;
+
+    if (!display_running) {
+        display_ring[back ^ 1U][display.nrows - 1U].dlast_sga = (int32_t)&display_ring[back ^ 1U][0];
+    }
+}
+
+
+void DISPLAY_SetBrightness(uint8_t row, uint8_t level)
+{
+    uint8_t i;
+
+    for (i = 0U; i < display.nrows; i++) {
+        if (row == i || row >= DISPLAY_MAX_ROWS) {
+            display_level[i] = level;
+            display_on[i] = (uint16_t)(1U + ((DISPLAY_ON_MAX - 1U) * level) / 255U);
+        }
+    }
+}
+
+
+void Test_DISPLAY(void)
+{
+    const display_cfg cfg = {
+        .rows = { PTE0, PTE1, PTE2, PTE3 },
+        .nrows = 4U,
+        .segs = { PTE4, PTE5, PTE6, PTE7, PTE8, PTE9, PTE10, PTE11 },
+        .nsegs = 8U,
+        .rows_low = true,                           // Common cathode digits
+        .segs_low = false,
+    };
+    uint16_t count = 0U;
+    uint8_t i;
+
+    DISPLAY_Init(&cfg);
+    DISPLAY_Start();
+
+    while(1)
+    {
+        /* Hex counter, the digit brightness falls from left to right */
+        for (i = 0U; i < 4U; i++) {
+            DISPLAY_SetRow(i, display_hex[(count >> (12U - 4U * i)) & 0x0FU]);
+            DISPLAY_SetBrightness(i, (uint8_t)(255U >> (2U * i)));
+        }
+        DISPLAY_SetRow(3U, display_hex[count & 0x0FU] | DISPLAY_SEG_DP);
+        DISPLAY_Show();
+
+        count++;
+        delay(100);
+    }
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Build the {PCOR, PSOR} words of every row from the frame buffer
+ * @param: buff: word buffer
+ */
+static void display_encode(uint8_t buff)
+{
+    uint32_t active, high;
+    uint8_t i, n;
+
+    for (i = 0U; i < display.nrows; i++) {
+        active = 0U;
+        if (display_level[i] != 0U) {
+            active = display_row_pins[i];
+            for (n = 0U; n < display.nsegs; n++) {
+                if (display_fb[i] & (1U << n)) {
+                    active |= display_seg_pins[n];
+                }
+            }
+        }
+
+        /* Pins to drive high: active high pins that are on, active low that are off */
+        high = (active ^ display_low_mask) & display_all_mask;
+        display_words[buff][i][0] = display_all_mask & ~high;
+        display_words[buff][i][1] = high;
+    }
+}
+
+
+/*
+ * @brief: Check if the ROW channel runs a ring
+ * @param: buff: ring index
+ * @return: true if the source address is inside the words of the ring
+ */
+static bool display_in_ring(uint8_t buff)
+{
+    uint32_t saddr = DMA->TCD[DMA_CH_DISPLAY_ROW].SADDR;
+
+    return (saddr >= (uint32_t)display_words[buff][0]) &&
+           (saddr <= (uint32_t)display_words[buff][display.nrows]);
+}
+
+
+/*
+ * @brief: Drive every row and segment to its inactive level
+ */
+static void display_pins_off(void)
+{
+    GPIOX[display_port]->PSOR = display_low_mask & display_all_mask;
+    GPIOX[display_port]->PCOR = ~display_low_mask & display_all_mask;
+}
@@ -55,12 +55,41 @@
 #define KEY_NOPRESS                    1U
 #define KEY_PRESS                      0U
 
+/* Hardware glitch filter of the key pins (LPO clock, max 242 us) */
+#define KEY_FILTER_US                  240U
+
 #define PREEM_PI_VALUE                 1U
 #define SUB_PI_VALUE                   2U
 
 //==============================================================================
 //                       LOCAL TYPES AND ENUMERATIONS
 //==============================================================================
+/* Vertical counter of one port, bit n of every word belongs to pin n */
+typedef struct {
+    uint32_t mask;                      // Pins debounced on this port
+    uint32_t ct0;                       // Counter bit 0
+    uint32_t ct1;                       // Counter bit 1
+    volatile uint32_t state;            // Debounced level, 1 = pressed
+    volatile uint32_t pressed;          // Press edges not read yet
+    volatile uint32_t released;         // Release edges not read yet
+} key_port_counter;
+
+/* Gesture state of a key */
+typedef enum {
+    KEY_STAGE_IDLE,
+    KEY_STAGE_LONG,                     // Pressed, waiting for the long press
+    KEY_STAGE_REPEAT,                   // Long press reported, repeating
+} key_stage;
+
+typedef struct {
+    uint16_t code;                      // 0: free slot
+    bool pressed;
+    uint8_t stage;                      // key_stage
+    uint8_t clicks;
+    uint8_t repeats;
+    uint32_t release_time;
+    uint32_t next_time;                 // Time of the next long or repeat event
+} key_gesture_slot;
 
 //==============================================================================
 //                           GLOBAL VARIABLES
@@ -69,11 +98,54 @@
 //==============================================================================
 //                          STATIC VARIABLES
 //==============================================================================
+/* LEDs toggled by each key in the interrupt test, zero terminated */
+static const uint8_t keyA_leds[] = { 3U, 0U };
+static const uint8_t keyB_leds[] = { 5U, 0U };
+static const uint8_t keyC_leds[] = { 6U, 4U, 0U };
+
+/* LEDs of each key, indexed by Key_types */
+static const uint8_t *const key_leds[KEY_MAX] = { NULL, keyA_leds, keyB_leds, keyC_leds };
+
+/* Pin of each key, indexed by Key_types */
+static const PTXn_e key_pins[KEY_MAX] = { KEYA_IO, KEYA_IO, KEYB_IO, KEYC_IO };
+
+/* Debounce state, updated from the software tick */
+static uint16_t key_count[KEY_MAX];
+static uint16_t press_ticks = KEY_PRESS_MS / KEY_TICK_MS;
+static uint16_t release_ticks = KEY_RELEASE_MS / KEY_TICK_MS;
+static volatile uint32_t key_state;
+static volatile uint32_t key_pressed;
+static volatile uint32_t key_released;
+static bool key_tick_running = false;
+
+/* Port debouncer */
+static key_port_counter key_ports[KEY_PORT_NUM];
+static bool key_port_running = false;
+
+/* Gesture engine, events queued from the tick and read from the main loop */
+static key_gesture_cfg gesture_cfg = { KEY_LONG_MS, KEY_DOUBLE_MS, KEY_REPEAT_MS };
+static key_gesture_slot gesture_table[KEY_GESTURE_SLOTS];
+static bool gesture_running = false;
+static volatile key_event event_queue[KEY_EVENT_QUEUE];
+static volatile uint8_t event_head;     // Written by key_event_post()
+static volatile uint8_t event_tail;     // Written by KEY_EventGet()
+static volatile uint32_t event_lost;
+
+/* Interrupt wake mode, keys waiting for the LPTMR confirmation */
+static volatile uint32_t wake_pending;
+static uint32_t wake_deadline[KEY_MAX];  // LPIT timestamp of the confirmation
 
 //==============================================================================
 //                      STATIC FUNCTION DECLARATIONS
 //==============================================================================
-static void key_delayms(int ms);
+static void key_tick(void *ctx);
+static void key_port_tick(void *ctx);
+static void key_gesture_tick(void *ctx);
+static void key_gesture_press(key_gesture_slot *slot, uint32_t now);
+static void key_event_post(uint16_t code, key_event_type type, uint8_t count, uint32_t time);
+static void key_wake_edge(PTXn_e ptx_n, void *ctx);
+static void key_wake_confirm(void *ctx);
+static void key_filter_init(void);
 
 //==============================================================================
 //                       PUBLIC FUNCTION DEFINITIONS
@@ -82,56 +154,239 @@ void KEY_Init(void)
 {
     GPIO_PinInit(KEYA_IO, GPI, 1);
     GPIO_PinInit(KEYB_IO, GPI, 1);
-    GPIO_PinInit(KEYA_IO, GPI, 1);
+    GPIO_PinInit(KEYC_IO, GPI, 1);
+
+    key_filter_init();
+
+    /* Sample the keys from the software tick */
+    if (!key_tick_running) {
+        key_tick_running = LPIT_TickAttach(key_tick, NULL, KEY_TICK_MS);
+    }
+}
+
+void KEY_WakeInit(void)
+{
+    uint8_t key;
+
+    LPTMR_Init();
+    LPIT_Init();
+
+    /* Both edges, the pin is masked from the first edge until confirmed */
+    for (key = KEY_A; key < KEY_MAX; key++) {
+        GPIO_ExtiAttach(key_pins[key], either_up, key_wake_edge, (void *)&key_pins[key]);
+    }
+
+    key_filter_init();
 }
 
 KeyStatus_types KEY_Read(Mode_types mode, Key_types key)
 {
-    const uint8_t keys[4] = {0, KEYA_IO, KEYB_IO, KEYC_IO};
-    const KeyStatus_types press[4] = { KSTATUS_NOPRESS, KSTATUS_B1_PRESS,
-                                      KSTATUS_B2_PRESS, KSTATUS_B3_PRESS };
-    static uint8_t pressKey[4] = { KEY_NOPRESS, KEY_NOPRESS, KEY_NOPRESS,
-                                   KEY_NOPRESS };
-    uint8_t readPin = KEY_NOPRESS;
-    KeyStatus_types keyStatus = KSTATUS_NOPRESS;
-
-    if ((key > KEY_NA) && (key < KEY_MAX)) {
-        if (MODE_CONT == mode) {
-            /* To support the continuous mode reset the pressKey value */
-            pressKey[key] = KEY_NOPRESS;
-        }
-
-        readPin = GPIO_PinRead(keys[key]);
-        if (KEY_PRESS == readPin) {
-            if (KEY_NOPRESS == pressKey[key]) {
-                /* Debounce time of 10ms */
-                key_delayms(10);
-                pressKey[key] = KEY_PRESS;
-                readPin = GPIO_PinRead(keys[key]);
-                if (KEY_PRESS == readPin) {
-                    keyStatus = press[key];
-                }
-                else {
-                    keyStatus = KSTATUS_NOPRESS;
-                }
-            }
+    uint32_t primask;
+    const KeyStatus_types press[KEY_MAX] = { KSTATUS_NOPRESS, KSTATUS_B1_PRESS,
+                                             KSTATUS_B2_PRESS, KSTATUS_B3_PRESS };
+    bool pressed;
+
+    if ((key <= KEY_NA) || (key >= KEY_MAX)) {
+        return KSTATUS_NOPRESS;
+    }
+
+    if (MODE_CONT == mode) {
+        /* Debounced level, reported as long as the key is held */
+        pressed = (key_state & KEY_MASK(key)) != 0U;
+    }
+    else {
+        /* Press edge, reported once per press */
+        DisableInterruptsSave(primask);
+        pressed = (key_pressed & KEY_MASK(key)) != 0U;
+        key_pressed &= ~KEY_MASK(key);
+        RestoreInterrupts(primask);
+    }
+
+    return pressed ? press[key] : KSTATUS_NOPRESS;
+}
+
+void KEY_SetDebounce(uint16_t press_ms, uint16_t release_ms)
+{
+    uint32_t primask;
+
+    DisableInterruptsSave(primask);
+    press_ticks = (press_ms >= KEY_TICK_MS) ? (press_ms / KEY_TICK_MS) : 1U;
+    release_ticks = (release_ms >= KEY_TICK_MS) ? (release_ms / KEY_TICK_MS) : 1U;
+    RestoreInterrupts(primask);
+}
+
+uint32_t KEY_GetState(void)
+{
+    return key_state;
+}
+
+uint32_t KEY_GetPressed(void)
+{
+    uint32_t primask;
+    uint32_t mask;
+
+    DisableInterruptsSave(primask);
+    mask = key_pressed;
+    key_pressed = 0U;
+    RestoreInterrupts(primask);
+
+    return mask;
+}
+
+uint32_t KEY_GetReleased(void)
+{
+    uint32_t primask;
+    uint32_t mask;
+
+    DisableInterruptsSave(primask);
+    mask = key_released;
+    key_released = 0U;
+    RestoreInterrupts(primask);
+
+    return mask;
+}
+
+void KEY_PortAdd(PTXn_e ptx_n)
+{
+    uint32_t primask;
+    uint8_t ptx = PTX(ptx_n);
+    uint32_t bit = 1UL << PTn(ptx_n);
+
+    GPIO_PinInit(ptx_n, GPI, 1);
+    PORTX[ptx]->PCR[PTn(ptx_n)] |= PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;     // Pull-up, keys to GND
+
+    /* Start from the current level with a full counter, no edge reported */
+    DisableInterruptsSave(primask);
+    key_ports[ptx].ct0 |= bit;
+    key_ports[ptx].ct1 |= bit;
+    if (GPIO_PinRead(ptx_n) == KEY_PRESS) {
+        key_ports[ptx].state |= bit;
+    }
+    else {
+        key_ports[ptx].state &= ~bit;
+    }
+    key_ports[ptx].mask |= bit;
+    RestoreInterrupts(primask);
+
+    if (!key_port_running) {
+        key_port_running = LPIT_TickAttach(key_port_tick, NULL, KEY_PORT_TICK_MS);
+    }
+}
+
+void KEY_PortRemove(PTXn_e ptx_n)
+{
+    uint32_t primask;
+    uint8_t ptx = PTX(ptx_n);
+    uint32_t bit = 1UL << PTn(ptx_n);
+
+    DisableInterruptsSave(primask);
+    key_ports[ptx].mask &= ~bit;
+    key_ports[ptx].state &= ~bit;
+    key_ports[ptx].pressed &= ~bit;
+    key_ports[ptx].released &= ~bit;
+    RestoreInterrupts(primask);
+}
+
+void KEY_PortRead(uint8_t port, key_port_status *status)
+{
+    uint32_t primask;
+
+    DisableInterruptsSave(primask);
+    status->state = key_ports[port].state;
+    status->pressed = key_ports[port].pressed;
+    status->released = key_ports[port].released;
+    key_ports[port].pressed = 0U;
+    key_ports[port].released = 0U;
+    RestoreInterrupts(primask);
+
+    status->changed = status->pressed | status->released;
+}
+
+void KEY_GestureConfig(const key_gesture_cfg *cfg)
+{
+    uint32_t primask;
+
+    DisableInterruptsSave(primask);
+    gesture_cfg = *cfg;
+    RestoreInterrupts(primask);
+}
+
+void KEY_EventFeed(uint16_t code, bool pressed)
+{
+    uint32_t primask;
+    uint32_t now;
+    key_gesture_slot *slot = NULL;
+    key_gesture_slot *free_slot = NULL;
+    uint8_t i;
+
+    /* The LPTMR confirmation and the LPIT ticks both feed events */
+    DisableInterruptsSave(primask);
+
+    /* Start the gesture tick before reading the time, it cannot stop meanwhile */
+    if (pressed && !gesture_running) {
+        gesture_running = LPIT_TickAttach(key_gesture_tick, NULL, KEY_GESTURE_TICK_MS);
+    }
+    now = LPIT_GetTicks();
+
+    for (i = 0U; i < KEY_GESTURE_SLOTS; i++) {
+        if (gesture_table[i].code == code) {
+            slot = &gesture_table[i];
+            break;
         }
-        else {
-            pressKey[key] = KEY_NOPRESS;
-            keyStatus = KSTATUS_NOPRESS;
+        if (gesture_table[i].code == 0U && free_slot == NULL) {
+            free_slot = &gesture_table[i];
+        }
+    }
+
+    if (slot == NULL && free_slot != NULL && pressed) {
+        slot = free_slot;
+        slot->code = code;
+        slot->clicks = 0U;
+    }
+
+    if (!pressed) {
+        key_event_post(code, KEY_EV_RELEASE, 0U, now);
+        if (slot != NULL) {
+            slot->pressed = false;
+            slot->stage = KEY_STAGE_IDLE;
+            slot->release_time = now;
         }
     }
     else {
-        pressKey[key] = KEY_NOPRESS;
-        keyStatus = KSTATUS_NOPRESS;
+        key_event_post(code, KEY_EV_PRESS, 0U, now);
+        /* No slot left, only press and release are reported */
+        if (slot != NULL) {
+            key_gesture_press(slot, now);
+        }
     }
+    RestoreInterrupts(primask);
+}
 
-    return keyStatus;
+uint8_t KEY_EventGet(key_event *events, uint8_t max)
+{
+    uint8_t tail = event_tail;
+    uint8_t head = event_head;
+    uint8_t n = 0U;
+
+    while (tail != head && n < max) {
+        events[n++] = event_queue[tail];
+        tail = (tail + 1U) & (KEY_EVENT_QUEUE - 1U);
+    }
+    event_tail = tail;
+
+    return n;
+}
+
+uint32_t KEY_EventGetLost(void)
+{
+    return event_lost;
 }
 
 void Test_KEY(void)
 {
+    key_event events[8];
     uint8_t index = 1U;
+    uint8_t n, i;
 
     /* Initialize LED and KET module */
     LED_Init();
@@ -139,16 +394,42 @@ void Test_KEY(void)
 
     while(1)
     {
-        if (KEY_Read(MODE_CONT, KEY_A) || KEY_Read(MODE_NOCONT, KEY_B))
-        {
-            if (index > MAX_LED) {
-                index = 1;
+        /* Sleep until the next interrupt, then handle all the pending events */
+        __asm("WFI");
+
+        n = KEY_EventGet(events, sizeof(events) / sizeof(events[0]));
+        for (i = 0U; i < n; i++) {
+            switch (events[i].type) {
+            case KEY_EV_PRESS:
+            case KEY_EV_REPEAT:
+                /* KEY_A and KEY_B step through the LEDs, holding repeats */
+                if (events[i].code == KEY_A || events[i].code == KEY_B) {
+                    if (index > MAX_LED) {
+                        index = 1;
+                    }
+                    LED_Reverse(index);
+                    index++;
+                }
+                break;
+            case KEY_EV_DOUBLE:
+                /* Double click on KEY_C restarts from the first LED */
+                if (events[i].code == KEY_C) {
+                    index = 1U;
+                }
+                break;
+            case KEY_EV_LONG:
+                /* Long press on KEY_C turns every LED off */
+                if (events[i].code == KEY_C) {
+                    for (index = 1U; index <= MAX_LED; index++) {
+                        LED_OFF(index);
+                    }
+                    index = 1U;
+                }
+                break;
+            default:
+                break;
             }
-            LED_Reverse(index);
-            index++;
         }
-
-        key_delayms(50);
     }
 
 }
@@ -157,14 +438,15 @@ void Test_KEYint(void)
 {
     uint32_t priority;
     uint32_t priorityGroup;
+    key_event events[8];
+    const uint8_t *led;
+    uint8_t n, i;
 
     /* Initialize LED module */
     LED_Init();
 
-    /* Configuration button interrupt with "Falling edge triggered, internal pull-up" */
-    GPIO_ExtiInit(KEYA_IO, falling_up);
-    GPIO_ExtiInit(KEYB_IO, falling_up);
-    GPIO_ExtiInit(KEYC_IO, falling_up);
+    /* Keys wake the core with an edge interrupt, a one-shot confirms the level */
+    KEY_WakeInit();
 
     /* Priority Configuration:  */
     priorityGroup = NVIC_GetPriorityGrouping();
@@ -178,22 +460,329 @@ void Test_KEYint(void)
     /* Enable interrupt for PORTD_IRQn */
     NVIC_EnableIRQ(PORTD_IRQn);
 
-    /* Infinite loop */
-    while(1);
+    while(1)
+    {
+        /* Sleep until a key edge, the confirmation or a gesture tick */
+        __asm("WFI");
+
+        n = KEY_EventGet(events, sizeof(events) / sizeof(events[0]));
+        for (i = 0U; i < n; i++) {
+            if (events[i].type == KEY_EV_PRESS && events[i].code < KEY_MAX) {
+                led = key_leds[events[i].code];
+                while (led != NULL && *led) {
+                    LED_Reverse(*led++);
+                }
+            }
+        }
+    }
 }
 
 //==============================================================================
 //                       STATIC FUNCTION DEFINITIONS
 //==============================================================================
-/* TODO: replace this way to set delay for a timer. */
-static void key_delayms(int ms)
+/*
+ * @brief: Sample the keys and run their debounce integrators
+ * @param: ctx: not used
+ * @note: The integrator counts up to press_ticks while the key reads pressed
+ *        (and down otherwise). Once pressed it counts down from release_ticks
+ *        while the key reads released, so isolated bounces only delay the edge.
+ */
+static void key_tick(void *ctx)
 {
-    volatile uint32_t i = 0;
+    uint8_t key;
+    bool raw;
 
-    while(ms--)
-    {
-        for (i = 0; i < 10000; ++i) {
-            __asm("NOP"); /* delay */
+    (void)ctx;
+    for (key = KEY_A; key < KEY_MAX; key++) {
+        raw = (KEY_PRESS == GPIO_PinRead(key_pins[key]));
+
+        if (!(key_state & KEY_MASK(key))) {
+            if (raw) {
+                if (++key_count[key] >= press_ticks) {
+                    key_count[key] = release_ticks;
+                    key_state |= KEY_MASK(key);
+                    key_pressed |= KEY_MASK(key);
+                    KEY_EventFeed(key, true);
+                }
+            }
+            else if (key_count[key] > 0U) {
+                key_count[key]--;
+            }
+        }
+        else {
+            if (!raw) {
+                if (--key_count[key] == 0U) {
+                    key_state &= ~KEY_MASK(key);
+                    key_released |= KEY_MASK(key);
+                    KEY_EventFeed(key, false);
+                }
+            }
+            else if (key_count[key] < release_ticks) {
+                key_count[key]++;
+            }
         }
     }
 }
+
+/*
+ * @brief: Debounce every registered pin with one PDIR read per port
+ * @param: ctx: not used
+ * @note: 2-bit vertical counters: a pin whose sample differs from its state
+ *        counts down from 3 and the state flips when the counter wraps, i.e.
+ *        after 4 consecutive samples. An equal sample reloads the counter.
+ */
+static void key_port_tick(void *ctx)
+{
+    key_port_counter *vc;
+    uint32_t delta;
+    uint8_t port, ptn;
+
+    (void)ctx;
+    for (port = 0U; port < KEY_PORT_NUM; port++) {
+        vc = &key_ports[port];
+        if (vc->mask == 0U) {
+            continue;
+        }
+
+        /* Keys are active low */
+        delta = (~GPIOX[port]->PDIR & vc->mask) ^ vc->state;
+
+        vc->ct0 = ~(vc->ct0 & delta);
+        vc->ct1 = vc->ct0 ^ (vc->ct1 & delta);
+        delta &= vc->ct0 & vc->ct1;
+
+        vc->state ^= delta;
+        vc->pressed |= vc->state & delta;
+        vc->released |= ~vc->state & delta;
+
+        while (delta) {
+            ptn = 31U - (uint8_t)__builtin_clz(delta);
+            delta &= ~(1UL << ptn);
+            KEY_EventFeed(KEY_CODE_PIN(port * 32U + ptn), (vc->state >> ptn) & 1U);
+        }
+    }
+}
+
+
+/*
+ * @brief: Start the gesture of a pressed key: double click and long press
+ * @param: slot: gesture slot of the key
+ * @param: now: software tick of the press
+ * @note: Called with the interrupts disabled
+ */
+static void key_gesture_press(key_gesture_slot *slot, uint32_t now)
+{
+    if (slot->clicks > 0U && (now - slot->release_time) <= gesture_cfg.double_ms) {
+        if (slot->clicks < 0xFFU) {
+            slot->clicks++;
+        }
+        key_event_post(slot->code, KEY_EV_DOUBLE, slot->clicks, now);
+    }
+    else {
+        slot->clicks = 1U;
+    }
+
+    slot->pressed = true;
+    slot->stage = KEY_STAGE_LONG;
+    slot->repeats = 0U;
+    slot->next_time = now + gesture_cfg.long_ms;
+}
+
+
+/*
+ * @brief: Report long presses and auto-repeat, free the idle slots
+ * @param: ctx: not used
+ */
+static void key_gesture_tick(void *ctx)
+{
+    uint32_t primask;
+    uint32_t now = LPIT_GetTicks();
+    key_gesture_slot *slot;
+    bool active = false;
+    uint8_t i;
+
+    (void)ctx;
+
+    /* KEY_EventFeed() may run from a higher priority interrupt */
+    DisableInterruptsSave(primask);
+    for (i = 0U; i < KEY_GESTURE_SLOTS; i++) {
+        slot = &gesture_table[i];
+        if (slot->code == 0U) {
+            continue;
+        }
+        active = true;
+
+        if (!slot->pressed) {
+            /* Keep the slot while a double click is still possible */
+            if ((now - slot->release_time) > gesture_cfg.double_ms) {
+                slot->code = 0U;
+            }
+        }
+        else if (slot->stage != KEY_STAGE_IDLE && (int32_t)(now - slot->next_time) >= 0) {
+            if (slot->stage == KEY_STAGE_LONG) {
+                key_event_post(slot->code, KEY_EV_LONG, 0U, now);
+            }
+            else {
+                if (slot->repeats < 0xFFU) {
+                    slot->repeats++;
+                }
+                key_event_post(slot->code, KEY_EV_REPEAT, slot->repeats, now);
+            }
+
+            if (gesture_cfg.repeat_ms > 0U) {
+                slot->stage = KEY_STAGE_REPEAT;
+                slot->next_time += gesture_cfg.repeat_ms;
+            }
+            else {
+                slot->stage = KEY_STAGE_IDLE;
+            }
+        }
+    }
+
+    /* Nothing to time, stop ticking until the next press */
+    if (!active) {
+        LPIT_TickDetach(key_gesture_tick, NULL);
+        gesture_running = false;
+    }
+    RestoreInterrupts(primask);
+}
+
+
+/*
+ * @brief: Push an event to the queue, from any interrupt
+ * @param: code: key identifier
+ * @param: type: event type
+ * @param: count: clicks or repeats
+ * @param: time: software tick of the event
+ */
+static void key_event_post(uint16_t code, key_event_type type, uint8_t count, uint32_t time)
+{
+    uint32_t primask;
+    uint8_t head;
+    uint8_t next;
+
+    /* Several producers, KEY_EventGet() stays lock-free on the tail */
+    DisableInterruptsSave(primask);
+    head = event_head;
+    next = (head + 1U) & (KEY_EVENT_QUEUE - 1U);
+    if (next == event_tail) {
+        event_lost++;
+    }
+    else {
+        event_queue[head].time = time;
+        event_queue[head].code = code;
+        event_queue[head].type = (uint8_t)type;
+        event_queue[head].count = count;
+        event_head = next;
+    }
+    RestoreInterrupts(primask);
+}
+
+
+/*
+ * @brief: First edge of a key in wake mode, mask it and start the confirmation
+ * @param: ptx_n: key pin
+ * @param: ctx: entry of the key in key_pins
+ */
+static void key_wake_edge(PTXn_e ptx_n, void *ctx)
+{
+    uint32_t primask;
+    uint8_t key = (uint8_t)((const PTXn_e *)ctx - key_pins);
+
+    /* Bounces of this pin do not interrupt again until the level is confirmed */
+    GPIO_ExtiMask(ptx_n);
+
+    /* Every key waits its own KEY_CONFIRM_MS, the one-shot is re-armed for the latest */
+    DisableInterruptsSave(primask);
+    wake_deadline[key] = LPIT_GetTimestamp() + LPIT_US_TO_TICKS(KEY_CONFIRM_MS * 1000U);
+    wake_pending |= KEY_MASK(key);
+    LPTMR_OneShot(KEY_CONFIRM_MS, key_wake_confirm, NULL);
+    RestoreInterrupts(primask);
+}
+
+
+/*
+ * @brief: One-shot expired, read the settled level of the pending keys
+ * @param: ctx: not used
+ */
+static void key_wake_confirm(void *ctx)
+{
+    const uint32_t ms_ticks = LPIT_US_TO_TICKS(1000U);
+    const uint32_t confirm = LPIT_US_TO_TICKS(KEY_CONFIRM_MS * 1000U);
+    uint32_t now = LPIT_GetTimestamp();
+    uint32_t primask;
+    uint32_t pending;
+    uint32_t again = 0U;
+    uint32_t wait = 0U;
+    uint32_t left;
+    bool pressed;
+    uint8_t key;
+
+    (void)ctx;
+
+    DisableInterruptsSave(primask);
+    pending = wake_pending;
+    wake_pending = 0U;
+    RestoreInterrupts(primask);
+
+    for (key = KEY_A; key < KEY_MAX; key++) {
+        if (!(pending & KEY_MASK(key))) {
+            continue;
+        }
+
+        /* Not settled for KEY_CONFIRM_MS yet, wait for its own deadline */
+        left = wake_deadline[key] - now;
+        if ((int32_t)left > 0) {
+            again |= KEY_MASK(key);
+            wait = (left > wait) ? left : wait;
+            continue;
+        }
+
+        pressed = (KEY_PRESS == GPIO_PinRead(key_pins[key]));
+        if (pressed != ((key_state & KEY_MASK(key)) != 0U)) {
+            if (pressed) {
+                key_state |= KEY_MASK(key);
+                key_pressed |= KEY_MASK(key);
+            }
+            else {
+                key_state &= ~KEY_MASK(key);
+                key_released |= KEY_MASK(key);
+            }
+            KEY_EventFeed(key, pressed);
+        }
+
+        GPIO_ExtiUnmask(key_pins[key], either_up);
+
+        /* The edge of a change while masked is lost, check the level again */
+        if ((KEY_PRESS == GPIO_PinRead(key_pins[key])) != pressed) {
+            GPIO_ExtiMask(key_pins[key]);
+            wake_deadline[key] = now + confirm;
+            again |= KEY_MASK(key);
+            wait = (confirm > wait) ? confirm : wait;
+        }
+    }
+
+    /* An edge interrupt may add keys meanwhile */
+    DisableInterruptsSave(primask);
+    wake_pending |= again;
+    RestoreInterrupts(primask);
+
+    if (wait > 0U) {
+        LPTMR_OneShot((uint16_t)((wait + ms_ticks - 1U) / ms_ticks), key_wake_confirm, NULL);
+    }
+}
+
+
+/*
+ * @brief: Enable the hardware glitch filter on the key pins
+ */
+static void key_filter_init(void)
+{
+    GPIO_DF_CLK clk;
+    uint8_t width;
+
+    (void)GPIO_DigitalFilterUs(KEY_FILTER_US, &clk, &width);
+    GPIO_DigitalFilterInit(KEYA_IO, clk, width);
+    GPIO_DigitalFilterInit(KEYB_IO, clk, width);
+    GPIO_DigitalFilterInit(KEYC_IO, clk, width);
+}
@@ -0,0 +1,305 @@
+/*
+ * =============================================================================
+ * File Name    : KEYPAD.c
+ * Project      : S32K144_basic
+ * Module       : Matrix Keypad Module
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Matrix keypad scanner. The row pins keep their output latch at 0 and a row
+ *   is selected by making only its pin an output with one masked write of
+ *   PDDR, the other rows stay in high impedance. The columns of the row are
+ *   read with one PDIR read. The 64-bit matrix is debounced with the same
+ *   vertical counters used by the KEY port debouncer.
+ *
+ *   Without diodes, three pressed corners of a rectangle make the fourth one
+ *   read as pressed. When two rows share two or more pressed columns the keys
+ *   of that rectangle are ambiguous: they keep their previous state until the
+ *   scan is clear again, the other keys are still reported (n-key rollover).
+ *
+ * Dependencies :
+ *   - GPIO driver
+ *   - KEY module
+ *   - LPIT driver
+ *
+ * Configuration :
+ *   - KEYPAD_TICK_MS: scan period, a key is accepted after 4 equal scans
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "KEYPAD.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define KEYPAD_ROW_BYTE(mask, row)     ((uint8_t)((mask) >> ((row) * KEYPAD_MAX_COLS)))
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+static keypad_cfg keypad;
+static uint8_t row_port;
+static uint8_t col_port;
+static uint32_t row_mask;               // PDDR bits of all the rows
+
+/* Debounce */
+static uint64_t ct0;
+static uint64_t ct1;
+static volatile uint64_t keypad_state;
+static volatile uint32_t keypad_ghosts;
+static bool keypad_running = false;
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static void keypad_tick(void *ctx);
+static uint64_t keypad_scan(void);
+static uint64_t keypad_ghost_mask(uint64_t raw);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+bool KEYPAD_Init(const keypad_cfg *cfg)
+{
+    uint8_t i;
+
+    if (cfg->nrows == 0U || cfg->nrows > KEYPAD_MAX_ROWS ||
+        cfg->ncols == 0U || cfg->ncols > KEYPAD_MAX_COLS) {
+        return false;
+    }
+
+    for (i = 1U; i < cfg->nrows; i++) {
+        if (PTX(cfg->rows[i]) != PTX(cfg->rows[0])) {
+            return false;
+        }
+    }
+    for (i = 1U; i < cfg->ncols; i++) {
+        if (PTX(cfg->cols[i]) != PTX(cfg->cols[0])) {
+            return false;
+        }
+    }
+
+    KEYPAD_Stop();
+
+    keypad = *cfg;
+    row_port = PTX(cfg->rows[0]);
+    col_port = PTX(cfg->cols[0]);
+    row_mask = 0U;
+
+    /* Rows: latch at 0, released as inputs until selected */
+    for (i = 0U; i < keypad.nrows; i++) {
+        GPIO_PinInit(keypad.rows[i], GPI, 0);
+        row_mask |= 1UL << PTn(keypad.rows[i]);
+    }
+
+    for (i = 0U; i < keypad.ncols; i++) {
+        GPIO_PinInit(keypad.cols[i], GPI, 1);
+        PORTX_BASE(keypad.cols[i])->PCR[PTn(keypad.cols[i])] |= PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;    // Pull-up
+    }
+
+    ct0 = ~0ULL;
+    ct1 = ~0ULL;
+    keypad_state = 0U;
+    keypad_ghosts = 0U;
+
+    return true;
+}
+
+
+void KEYPAD_Start(void)
+{
+    if (!keypad_running) {
+        keypad_running = LPIT_TickAttach(keypad_tick, NULL, KEYPAD_TICK_MS);
+    }
+}
+
+
+void KEYPAD_Stop(void)
+{
+    if (keypad_running) {
+        LPIT_TickDetach(keypad_tick, NULL);
+        keypad_running = false;
+    }
+    GPIOX[row_port]->PDDR &= ~row_mask;
+}
+
+
+uint64_t KEYPAD_GetState(void)
+{
+    uint32_t primask;
+    uint64_t state;
+
+    DisableInterruptsSave(primask);
+    state = keypad_state;
+    RestoreInterrupts(primask);
+
+    return state;
+}
+
+
+uint32_t KEYPAD_GetGhosts(void)
+{
+    return keypad_ghosts;
+}
+
+
+void Test_KEYPAD(void)
+{
+    const keypad_cfg cfg = {
+        { PTE13, PTE14, PTE15, PTE16 }, 4U,
+        { PTB8, PTB9, PTB10, PTB11 }, 4U,
+    };
+    const char names[] = "123A456B789C*0#D";
+    key_event events[8];
+    uint16_t n;
+    uint8_t count, i;
+
+    if (!KEYPAD_Init(&cfg)) {
+        return;
+    }
+    KEYPAD_Start();
+
+    while(1)
+    {
+        __asm("WFI");
+
+        count = KEY_EventGet(events, sizeof(events) / sizeof(events[0]));
+        for (i = 0U; i < count; i++) {
+            if (events[i].code < KEY_CODE_MATRIX(0U)) {
+                continue;
+            }
+
+            n = events[i].code - KEY_CODE_MATRIX(0U);
+            if (events[i].type == KEY_EV_PRESS) {
+                printf("KEYPAD %c at %lu ms\n", names[(n / KEYPAD_MAX_COLS) * 4U + n % KEYPAD_MAX_COLS],
+                       (unsigned long)events[i].time);
+            }
+            else if (events[i].type == KEY_EV_LONG) {
+                printf("KEYPAD %c long\n", names[(n / KEYPAD_MAX_COLS) * 4U + n % KEYPAD_MAX_COLS]);
+            }
+        }
+    }
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Scan and debounce the matrix, report the edges to the KEY queue
+ * @param: ctx: not used
+ */
+static void keypad_tick(void *ctx)
+{
+    uint64_t raw, ghost, delta;
+    uint8_t bit;
+
+    (void)ctx;
+    raw = keypad_scan();
+
+    /* Ambiguous keys keep their last state */
+    ghost = keypad_ghost_mask(raw);
+    if (ghost) {
+        keypad_ghosts++;
+        raw = (raw & ~ghost) | (keypad_state & ghost);
+    }
+
+    /* 2-bit vertical counters, see key_port_tick() */
+    delta = raw ^ keypad_state;
+    ct0 = ~(ct0 & delta);
+    ct1 = ct0 ^ (ct1 & delta);
+    delta &= ct0 & ct1;
+    keypad_state ^= delta;
+
+    while (delta) {
+        bit = (uint8_t)__builtin_ctzll(delta);
+        delta &= delta - 1U;
+        KEY_EventFeed(KEY_CODE_MATRIX(bit), (keypad_state >> bit) & 1U);
+    }
+}
+
+
+/*
+ * @brief: Read the whole matrix
+ * @return: raw pressed keys, KEYPAD_BIT(row, col)
+ */
+static uint64_t keypad_scan(void)
+{
+    GPIO_MemMapPtr rows = GPIOX[row_port];
+    uint64_t raw = 0U;
+    uint32_t pdir, start;
+    uint8_t row, col;
+
+    for (row = 0U; row < keypad.nrows; row++) {
+        /* Select the row: only its pin is an output (driving 0) */
+        rows->PDDR = (rows->PDDR & ~row_mask) | (1UL << PTn(keypad.rows[row]));
+
+        start = LPIT_GetTimestamp();
+        while ((LPIT_GetTimestamp() - start) < LPIT_US_TO_TICKS(KEYPAD_SETTLE_US));
+
+        pdir = ~GPIOX[col_port]->PDIR;
+        for (col = 0U; col < keypad.ncols; col++) {
+            if (pdir & (1UL << PTn(keypad.cols[col]))) {
+                raw |= KEYPAD_BIT(row, col);
+            }
+        }
+    }
+
+    rows->PDDR &= ~row_mask;
+
+    return raw;
+}
+
+
+/*
+ * @brief: Find the keys that can be ghosts
+ * @param: raw: raw matrix
+ * @return: keys of every rectangle with all four corners pressed
+ */
+static uint64_t keypad_ghost_mask(uint64_t raw)
+{
+    uint64_t ghost = 0U;
+    uint8_t a, b, shared;
+
+    for (a = 0U; a < keypad.nrows; a++) {
+        if (KEYPAD_ROW_BYTE(raw, a) == 0U) {
+            continue;
+        }
+        for (b = a + 1U; b < keypad.nrows; b++) {
+            shared = KEYPAD_ROW_BYTE(raw, a) & KEYPAD_ROW_BYTE(raw, b);
+            /* Two shared columns or more */
+            if (shared & (shared - 1U)) {
+                ghost |= ((uint64_t)shared << (a * KEYPAD_MAX_COLS)) |
+                         ((uint64_t)shared << (b * KEYPAD_MAX_COLS));
+            }
+        }
+    }
+
+    return ghost;
+}
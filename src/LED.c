@@ -14,8 +14,8 @@
  *   state.
  *
  *   LED pin mappings:
- *     - LED1_IO : PTC17 (Core board)
- *     - LED2_IO : PTD17
+ *     - LED1_IO : PTC17 (Core board, active-low)
+ *     - LED2_IO : PTD17 (active-low)
  *     - LED3_IO : PTA11
  *     - LED4_IO : PTA12
  *     - LED5_IO : PTA13
@@ -25,7 +25,7 @@
  *   - GPIO driver
  *
  * Configuration :
- *   - Output mode, active-high logic
+ *   - Output mode, polarity of each LED in led_table
  *
  * License :
  *   This file is part of a free software project released under the terms of
@@ -54,6 +54,11 @@
 //==============================================================================
 //                       LOCAL TYPES AND ENUMERATIONS
 //==============================================================================
+/* LED descriptor */
+typedef struct {
+    PTXn_e pin;
+    bool active_low;                    // Pin at 0 turns the LED on
+} led_desc;
 
 //==============================================================================
 //                           GLOBAL VARIABLES
@@ -62,137 +67,184 @@
 //==============================================================================
 //                          STATIC VARIABLES
 //==============================================================================
+/* Add more LEDs here and update MAX_LED */
+static const led_desc led_table[MAX_LED] = {
+    { LED1_IO, true  },
+    { LED2_IO, true  },
+    { LED3_IO, false },
+    { LED4_IO, false },
+    { LED5_IO, false },
+    { LED6_IO, false },
+};
+
+/* Per port: pins of active-low LEDs */
+static uint32_t led_port_low[5];
 
 //==============================================================================
 //                      STATIC FUNCTION DECLARATIONS
 //==============================================================================
-static void led_delayms(int ms);
 
 //==============================================================================
 //                       PUBLIC FUNCTION DEFINITIONS
 //==============================================================================
 void LED_Init(void)
 {
-    GPIO_PinInit(LED1_IO, GPO, 0);
-    GPIO_PinInit(LED2_IO, GPO, 0);
-    GPIO_PinInit(LED3_IO, GPO, 0);
-    GPIO_PinInit(LED4_IO, GPO, 0);
-    GPIO_PinInit(LED5_IO, GPO, 0);
-    GPIO_PinInit(LED6_IO, GPO, 0);
+    uint8_t i, ptx;
+
+    for (i = 0U; i < MAX_LED; i++) {
+        ptx = PTX(led_table[i].pin);
+
+        /* Start with every LED off */
+        GPIO_PinInit(led_table[i].pin, GPO, led_table[i].active_low ? 1 : 0);
+
+        if (led_table[i].active_low) {
+            led_port_low[ptx] |= 1UL << PTn(led_table[i].pin);
+        }
+    }
 }
 
 void LED_ON(uint8_t led)
 {
-    switch(led) {
-      case 1:
-        GPIO_PinWrite(LED1_IO,  0);
-        break;
-      case 2:
-        GPIO_PinWrite(LED2_IO,  0);
-        break;
-      case 3:
-        GPIO_PinWrite(LED3_IO,  1);
-        break;
-      case 4:
-        GPIO_PinWrite(LED4_IO,  1);
-        break;
-      case 5:
-        GPIO_PinWrite(LED5_IO,  1);
-        break;
-      case 6:
-        GPIO_PinWrite(LED6_IO,  1);
-        break;
-      default:
-        break;
+    const led_desc *desc;
+
+    if ((led == 0U) || (led > MAX_LED)) {
+        return;
+    }
+
+    desc = &led_table[led - 1U];
+    if (desc->active_low) {
+        GPIOX[PTX(desc->pin)]->PCOR = 1UL << PTn(desc->pin);
+    }
+    else {
+        GPIOX[PTX(desc->pin)]->PSOR = 1UL << PTn(desc->pin);
     }
 }
 
 void LED_OFF(uint8_t led)
 {
-    switch(led) {
-      case 1:
-        GPIO_PinWrite(LED1_IO, 1);
-        break;
-      case 2:
-        GPIO_PinWrite(LED2_IO, 1);
-        break;
-      case 3:
-        GPIO_PinWrite(LED3_IO, 0);
-        break;
-      case 4:
-        GPIO_PinWrite(LED4_IO, 0);
-        break;
-      case 5:
-        GPIO_PinWrite(LED5_IO, 0);
-        break;
-      case 6:
-        GPIO_PinWrite(LED6_IO, 0);
-        break;
-      default:
-        break;
+    const led_desc *desc;
+
+    if ((led == 0U) || (led > MAX_LED)) {
+        return;
+    }
+
+    desc = &led_table[led - 1U];
+    if (desc->active_low) {
+        GPIOX[PTX(desc->pin)]->PSOR = 1UL << PTn(desc->pin);
+    }
+    else {
+        GPIOX[PTX(desc->pin)]->PCOR = 1UL << PTn(desc->pin);
     }
 }
 
 void LED_Reverse(uint8_t led)
 {
-    switch(led) {
-      case 1:
-        GPIO_PinReverse(LED1_IO);
-        break;
-      case 2:
-        GPIO_PinReverse(LED2_IO);
-        break;
-      case 3:
-        GPIO_PinReverse(LED3_IO);
-        break;
-      case 4:
-        GPIO_PinReverse(LED4_IO);
-        break;
-      case 5:
-        GPIO_PinReverse(LED5_IO);
-        break;
-      case 6:
-        GPIO_PinReverse(LED6_IO);
-        break;
-      default:
-        break;
+    if ((led == 0U) || (led > MAX_LED)) {
+        return;
     }
+
+    GPIOX[PTX(led_table[led - 1U].pin)]->PTOR = 1UL << PTn(led_table[led - 1U].pin);
 }
 
-void Test_LED(void)
+void LED_SetMask(uint32_t on_mask)
 {
-    uint8_t index = 0U;
+    LED_UpdateMask(on_mask, 0xFFFFFFFFU);
+}
 
-    LED_Init();
+void LED_UpdateMask(uint32_t on_mask, uint32_t sel_mask)
+{
+    uint32_t level[5] = { 0U, 0U, 0U, 0U, 0U };
+    uint32_t sel[5] = { 0U, 0U, 0U, 0U, 0U };
+    uint32_t high, bit;
+    uint8_t i, ptx;
 
-    while(1)
-    {
-        for (index = 1U; index <= MAX_LED; index++) {
-            if (index == 1U){
-                LED_OFF(MAX_LED);
-            }
-            else {
-                LED_OFF(index - 1U);
+    /* Pins to update, and the ones where an active-high LED is lit */
+    for (i = 0U; i < MAX_LED; i++) {
+        if (sel_mask & (1UL << i)) {
+            ptx = PTX(led_table[i].pin);
+            bit = 1UL << PTn(led_table[i].pin);
+            sel[ptx] |= bit;
+            if (on_mask & (1UL << i)) {
+                level[ptx] |= bit;
             }
-            LED_ON(index);
-            led_delayms(200);
+        }
+    }
+
+    for (ptx = 0U; ptx < 5U; ptx++) {
+        if (sel[ptx] == 0U) {
+            continue;
         }
 
+        /* Active-low pins are inverted. PSOR/PCOR only touch their own pins,
+           so an interrupt updating other LEDs meanwhile is not undone */
+        high = level[ptx] ^ led_port_low[ptx];
+        if (high & sel[ptx]) {
+            GPIOX[ptx]->PSOR = high & sel[ptx];
+        }
+        if (~high & sel[ptx]) {
+            GPIOX[ptx]->PCOR = ~high & sel[ptx];
+        }
     }
 }
 
-//==============================================================================
-//                       STATIC FUNCTION DEFINITIONS
-//==============================================================================
-/* TODO: replace this way to set delay for a timer. */
-static void led_delayms(int ms)
+uint32_t LED_GetMask(void)
 {
-    volatile uint32_t i = 0;
+    uint32_t mask = 0U;
+    uint32_t pdor;
+    uint8_t i, ptx;
 
-    while(ms--)
-    {
-        for (i = 0; i < 10000; ++i) {
-            __asm("NOP"); /* delay */
+    for (i = 0U; i < MAX_LED; i++) {
+        ptx = PTX(led_table[i].pin);
+        pdor = GPIOX[ptx]->PDOR ^ led_port_low[ptx];
+        if (pdor & (1UL << PTn(led_table[i].pin))) {
+            mask |= 1UL << i;
         }
     }
+
+    return mask;
+}
+
+PTXn_e LED_GetPin(uint8_t led)
+{
+    if ((led == 0U) || (led > MAX_LED)) {
+        return LED_NO_PIN;
+    }
+
+    return led_table[led - 1U].pin;
 }
+
+bool LED_IsActiveLow(uint8_t led)
+{
+    if ((led == 0U) || (led > MAX_LED)) {
+        return false;
+    }
+
+    return led_table[led - 1U].active_low;
+}
+
+void Test_LED(void)
+{
+    /* On for 200 ms, then 200 ms off for each other LED (durations are 8-bit) */
+    static const uint8_t chaser[] = {
+        LP_LOOP(0),
+            LP_ON(LP_MS(200)),
+            LP_LOOP(MAX_LED - 1U), LP_OFF(LP_MS(200)), LP_NEXT,
+        LP_NEXT, LP_END,
+    };
+    uint8_t index = 0U;
+
+    LEDPAT_Init();
+
+    for (index = 1U; index <= MAX_LED; index++) {
+        LEDPAT_Start(index, chaser, 200U * (index - 1U));
+    }
+
+    while(1)
+    {
+        __asm("WFI");
+    }
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
@@ -0,0 +1,347 @@
+/*
+ * =============================================================================
+ * File Name    : LEDPAT.c
+ * Project      : S32K144_basic
+ * Module       : LED Pattern Module
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Bytecode interpreter for LED patterns. Every LEDPAT_TICK_MS each running
+ *   LED counts down the duration of its current instruction; when it expires
+ *   the next instructions are executed until one with a duration is found.
+ *   On/off LEDs are collected in a mask and written with one LED_UpdateMask()
+ *   call. LEDs with fades are driven by a BAM channel.
+ *
+ * Dependencies :
+ *   - LED, BAM modules
+ *   - LPIT driver
+ *
+ * Configuration :
+ *   - None
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "LEDPAT.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define LEDPAT_LEVEL_ON                255U
+#define LEDPAT_MAX_OPS                 16U     // Instructions per tick without duration
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+typedef struct {
+    const uint8_t *pc;                  // Next instruction, NULL: not running
+    uint16_t wait;                      // Ticks left (start delay up to 65535 ms)
+    uint8_t level;                      // 0 (off) .. 255 (on)
+    uint8_t fade_from;
+    uint8_t fade_to;
+    uint8_t fade_len;                   // 0: no fade running
+    uint8_t depth;                      // Loops open
+    const uint8_t *loop_pc[LEDPAT_LOOP_DEPTH];
+    uint8_t loop_count[LEDPAT_LOOP_DEPTH];
+    uint8_t bam_ch;                     // BAM_INVALID_CH: on/off LED
+} ledpat_state;
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+/* Single 50 ms flash */
+const uint8_t ledpat_flash[] = {
+    LP_ON(LP_MS(50)), LP_OFF(1), LP_END,
+};
+
+/* 1 Hz blink */
+const uint8_t ledpat_blink[] = {
+    LP_LOOP(0), LP_ON(LP_MS(500)), LP_OFF(LP_MS(500)), LP_NEXT, LP_END,
+};
+
+/* Two short beats every 1.2 s */
+const uint8_t ledpat_heartbeat[] = {
+    LP_LOOP(0),
+        LP_ON(LP_MS(80)), LP_OFF(LP_MS(120)), LP_ON(LP_MS(80)), LP_OFF(LP_MS(920)),
+    LP_NEXT, LP_END,
+};
+
+/* "... --- ..." in Morse, 150 ms dot */
+const uint8_t ledpat_sos[] = {
+    LP_LOOP(0),
+        LP_LOOP(3), LP_ON(LP_MS(150)), LP_OFF(LP_MS(150)), LP_NEXT,
+        LP_OFF(LP_MS(300)),
+        LP_LOOP(3), LP_ON(LP_MS(450)), LP_OFF(LP_MS(150)), LP_NEXT,
+        LP_OFF(LP_MS(300)),
+        LP_LOOP(3), LP_ON(LP_MS(150)), LP_OFF(LP_MS(150)), LP_NEXT,
+        LP_OFF(LP_MS(1050)),
+    LP_NEXT, LP_END,
+};
+
+/* 2 s breathing */
+const uint8_t ledpat_breathe[] = {
+    LP_LOOP(0), LP_FADE(255, LP_MS(1000)), LP_FADE(0, LP_MS(1000)), LP_NEXT, LP_END,
+};
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+static ledpat_state ledpat_table[MAX_LED];
+static bool ledpat_ready = false;
+static bool ledpat_ticking = false;
+
+/* Length of every instruction, indexed by opcode */
+static const uint8_t ledpat_op_len[] = { 1U, 2U, 2U, 3U, 2U, 1U };
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static void ledpat_tick(void *ctx);
+static void ledpat_run(ledpat_state *st);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+void LEDPAT_Init(void)
+{
+    uint8_t i;
+
+    if (ledpat_ready) {
+        return;
+    }
+
+    LED_Init();
+    for (i = 0U; i < MAX_LED; i++) {
+        ledpat_table[i].pc = NULL;
+        ledpat_table[i].bam_ch = BAM_INVALID_CH;
+    }
+
+    ledpat_ready = true;
+}
+
+
+bool LEDPAT_Start(uint8_t led, const uint8_t *pattern, uint16_t delay_ms)
+{
+    uint32_t primask;
+    ledpat_state *st;
+    const uint8_t *op;
+    bool fades = false;
+
+    if ((led == 0U) || (led > MAX_LED)) {
+        return false;
+    }
+    st = &ledpat_table[led - 1U];
+
+    for (op = pattern; *op != LP_OP_END; op += ledpat_op_len[*op]) {
+        fades |= (*op == LP_OP_FADE);
+    }
+
+    /* Fades need intermediate levels: hand the pin to the BAM engine */
+    if (fades && st->bam_ch == BAM_INVALID_CH) {
+        st->bam_ch = BAM_Attach(LED_GetPin(led), LED_IsActiveLow(led));
+        BAM_SetDuty(st->bam_ch, st->level);
+        BAM_Start();
+    }
+
+    DisableInterruptsSave(primask);
+    st->pc = pattern;
+    st->wait = LP_MS(delay_ms);
+    st->fade_len = 0U;
+    st->depth = 0U;
+
+    /* Ticking only while a pattern runs, the tick detaches itself */
+    if (!ledpat_ticking) {
+        ledpat_ticking = LPIT_TickAttach(ledpat_tick, NULL, LEDPAT_TICK_MS);
+    }
+    RestoreInterrupts(primask);
+
+    return true;
+}
+
+
+void LEDPAT_Stop(uint8_t led, bool on)
+{
+    uint32_t primask;
+    ledpat_state *st;
+
+    if ((led == 0U) || (led > MAX_LED)) {
+        return;
+    }
+    st = &ledpat_table[led - 1U];
+
+    DisableInterruptsSave(primask);
+    st->pc = NULL;
+    st->level = on ? LEDPAT_LEVEL_ON : 0U;
+    RestoreInterrupts(primask);
+
+    if (st->bam_ch != BAM_INVALID_CH) {
+        BAM_SetDuty(st->bam_ch, st->level);
+    }
+    else if (on) {
+        LED_ON(led);
+    }
+    else {
+        LED_OFF(led);
+    }
+}
+
+
+bool LEDPAT_IsRunning(uint8_t led)
+{
+    return ((led > 0U) && (led <= MAX_LED) && (ledpat_table[led - 1U].pc != NULL));
+}
+
+
+void Test_LEDPAT(void)
+{
+    LEDPAT_Init();
+
+    LEDPAT_Start(1U, ledpat_blink, 0U);
+    LEDPAT_Start(2U, ledpat_heartbeat, 0U);
+    LEDPAT_Start(3U, ledpat_sos, 0U);
+    LEDPAT_Start(4U, ledpat_breathe, 0U);
+    LEDPAT_Start(5U, ledpat_breathe, 660U);
+    LEDPAT_Start(6U, ledpat_breathe, 1330U);
+
+    while(1)
+    {
+        __asm("WFI");
+    }
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Advance every running pattern and write the LEDs
+ * @param: ctx: not used
+ */
+static void ledpat_tick(void *ctx)
+{
+    uint32_t on_mask = 0U;
+    uint32_t sel_mask = 0U;
+    ledpat_state *st;
+    bool running = false;
+    uint8_t i, level;
+
+    (void)ctx;
+    for (i = 0U; i < MAX_LED; i++) {
+        st = &ledpat_table[i];
+        if (st->pc == NULL) {
+            continue;
+        }
+
+        if (st->wait > 0U) {
+            st->wait--;
+        }
+
+        if (st->fade_len > 0U) {
+            st->level = (uint8_t)(st->fade_from + ((int16_t)(st->fade_to - st->fade_from) *
+                                  (int16_t)(st->fade_len - st->wait)) / (int16_t)st->fade_len);
+        }
+
+        if (st->wait == 0U) {
+            ledpat_run(st);
+        }
+
+        running |= (st->pc != NULL);
+        level = st->level;
+        if (st->bam_ch != BAM_INVALID_CH) {
+            if (BAM_GetDuty(st->bam_ch) != level) {
+                BAM_SetDuty(st->bam_ch, level);
+            }
+        }
+        else {
+            sel_mask |= 1UL << i;
+            if (level >= 128U) {
+                on_mask |= 1UL << i;
+            }
+        }
+    }
+
+    if (sel_mask) {
+        LED_UpdateMask(on_mask, sel_mask);
+    }
+
+    /* Last pattern ended or stopped, no tick until the next LEDPAT_Start() */
+    if (!running) {
+        LPIT_TickDetach(ledpat_tick, NULL);
+        ledpat_ticking = false;
+    }
+}
+
+
+/*
+ * @brief: Execute instructions until one with a duration (or the end)
+ * @param: st: LED state
+ */
+static void ledpat_run(ledpat_state *st)
+{
+    const uint8_t *pc = st->pc;
+    uint8_t ops;
+
+    st->fade_len = 0U;
+
+    for (ops = 0U; ops < LEDPAT_MAX_OPS; ops++) {
+        switch (pc[0]) {
+        case LP_OP_ON:
+        case LP_OP_OFF:
+            st->level = (pc[0] == LP_OP_ON) ? LEDPAT_LEVEL_ON : 0U;
+            st->wait = pc[1];
+            st->pc = pc + 2;
+            return;
+        case LP_OP_FADE:
+            st->fade_from = st->level;
+            st->fade_to = pc[1];
+            st->fade_len = (pc[2] > 0U) ? pc[2] : 1U;
+            st->wait = st->fade_len;
+            st->pc = pc + 3;
+            return;
+        case LP_OP_LOOP:
+            if (st->depth < LEDPAT_LOOP_DEPTH) {
+                st->loop_pc[st->depth] = pc + 2;
+                st->loop_count[st->depth] = pc[1];
+                st->depth++;
+            }
+            pc += 2;
+            break;
+        case LP_OP_NEXT:
+            if (st->depth == 0U) {
+                pc += 1;
+            }
+            else if (st->loop_count[st->depth - 1U] == 0U || --st->loop_count[st->depth - 1U] > 0U) {
+                pc = st->loop_pc[st->depth - 1U];
+            }
+            else {
+                st->depth--;
+                pc += 1;
+            }
+            break;
+        case LP_OP_END:
+        default:
+            st->pc = NULL;
+            return;
+        }
+    }
+
+    /* Loop without any duration, keep going from here on the next tick */
+    st->pc = pc;
+}
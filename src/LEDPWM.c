@@ -0,0 +1,368 @@
+/*
+ * =============================================================================
+ * File Name    : LEDPWM.c
+ * Project      : S32K144_basic
+ * Module       : LED PWM Dimming Module
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Every PWM period the FTM channel match raises a DMA request. A divider
+ *   channel counts these requests and, every "k" periods, links to a writer
+ *   channel that copies the next lookup table entry to CnV. The FTM loads CnV
+ *   at the end of the period (PWMLOAD), so steps never glitch. When the fade
+ *   ends, the writer switches by scatter/gather to a hold descriptor that
+ *   keeps copying the final entry.
+ *
+ *   A fade of n levels lasting t ms uses k = t * LEDPWM_HZ / (1000 * n).
+ *
+ * Dependencies :
+ *   - FTM, DMA drivers
+ *   - LED module
+ *
+ * Configuration :
+ *   - DMA_CH_LEDPWM_DIV + slot: divider channels
+ *   - DMA_CH_LEDPWM_WR + slot: writer channels
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "LEDPWM.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define LEDPWM_NO_SLOT                 0xFFU
+#define LEDPWM_DIV_MAX                 0x7FFFU  // Major loop count without link
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+typedef struct {
+    uint8_t led;                        // 0: free
+    uint8_t ch;                         // FTM channel
+    const uint16_t *lut;                // Curve of the last fade
+    dma_tcd hold;                       // Keeps writing the final entry
+} ledpwm_slot;
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+/* round(7999 * (i / 255) ^ 2.2) */
+static const uint16_t ledpwm_gamma[LEDPWM_LEVEL_MAX + 1U] = {
+       0,    0,    0,    0,    1,    1,    2,    3,    4,    5,    6,    8,
+      10,   11,   13,   16,   18,   21,   23,   26,   30,   33,   36,   40,
+      44,   48,   53,   57,   62,   67,   72,   78,   83,   89,   95,  101,
+     108,  114,  121,  129,  136,  143,  151,  159,  168,  176,  185,  194,
+     203,  212,  222,  232,  242,  252,  263,  274,  285,  296,  308,  320,
+     332,  344,  356,  369,  382,  395,  409,  423,  437,  451,  465,  480,
+     495,  510,  526,  542,  558,  574,  591,  607,  624,  642,  659,  677,
+     695,  713,  732,  751,  770,  789,  809,  829,  849,  870,  890,  911,
+     932,  954,  976,  998, 1020, 1043, 1066, 1089, 1112, 1136, 1160, 1184,
+    1208, 1233, 1258, 1283, 1309, 1335, 1361, 1387, 1414, 1441, 1468, 1496,
+    1524, 1552, 1580, 1609, 1637, 1667, 1696, 1726, 1756, 1786, 1817, 1848,
+    1879, 1910, 1942, 1974, 2006, 2039, 2072, 2105, 2139, 2172, 2206, 2241,
+    2275, 2310, 2345, 2381, 2417, 2453, 2489, 2526, 2563, 2600, 2638, 2675,
+    2713, 2752, 2791, 2830, 2869, 2908, 2948, 2989, 3029, 3070, 3111, 3152,
+    3194, 3236, 3278, 3321, 3364, 3407, 3450, 3494, 3538, 3583, 3627, 3672,
+    3717, 3763, 3809, 3855, 3902, 3948, 3996, 4043, 4091, 4139, 4187, 4236,
+    4285, 4334, 4383, 4433, 4483, 4534, 4585, 4636, 4687, 4739, 4791, 4843,
+    4896, 4949, 5002, 5056, 5110, 5164, 5218, 5273, 5328, 5384, 5439, 5496,
+    5552, 5609, 5666, 5723, 5781, 5839, 5897, 5955, 6014, 6074, 6133, 6193,
+    6253, 6314, 6375, 6436, 6497, 6559, 6621, 6683, 6746, 6809, 6873, 6936,
+    7000, 7065, 7129, 7194, 7259, 7325, 7391, 7457, 7524, 7591, 7658, 7726,
+    7793, 7862, 7930, 7999,
+};
+
+/* round(7999 * 7999 ^ ((i - 255) / 254)), 0 for i = 0 */
+static const uint16_t ledpwm_exp[LEDPWM_LEVEL_MAX + 1U] = {
+       0,    1,    1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    2,    2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
+       2,    2,    2,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+       3,    4,    4,    4,    4,    4,    4,    4,    5,    5,    5,    5,
+       5,    5,    6,    6,    6,    6,    7,    7,    7,    7,    8,    8,
+       8,    8,    9,    9,    9,   10,   10,   10,   11,   11,   11,   12,
+      12,   13,   13,   14,   14,   15,   15,   16,   16,   17,   18,   18,
+      19,   20,   20,   21,   22,   23,   23,   24,   25,   26,   27,   28,
+      29,   30,   31,   32,   33,   34,   36,   37,   38,   40,   41,   43,
+      44,   46,   47,   49,   51,   53,   54,   56,   58,   61,   63,   65,
+      67,   70,   72,   75,   78,   80,   83,   86,   89,   93,   96,   99,
+     103,  107,  111,  115,  119,  123,  127,  132,  137,  142,  147,  152,
+     158,  163,  169,  175,  181,  188,  195,  202,  209,  217,  224,  232,
+     241,  250,  259,  268,  277,  287,  298,  309,  320,  331,  343,  355,
+     368,  382,  395,  410,  424,  440,  455,  472,  489,  506,  525,  543,
+     563,  583,  604,  626,  649,  672,  696,  721,  747,  774,  802,  831,
+     861,  892,  924,  957,  992, 1028, 1065, 1103, 1143, 1184, 1226, 1271,
+    1316, 1364, 1413, 1464, 1516, 1571, 1628, 1686, 1747, 1810, 1875, 1943,
+    2013, 2085, 2160, 2238, 2319, 2402, 2489, 2578, 2671, 2767, 2867, 2970,
+    3077, 3188, 3303, 3422, 3545, 3673, 3805, 3942, 4084, 4231, 4383, 4541,
+    4705, 4874, 5050, 5232, 5420, 5615, 5818, 6027, 6244, 6469, 6702, 6943,
+    7193, 7453, 7721, 7999,
+};
+
+static ledpwm_slot ledpwm_table[LEDPWM_MAX];
+static uint8_t ledpwm_slot_of[MAX_LED + 1U];
+static uint32_t ledpwm_dummy;           // Target of the divider transfers
+static bool ledpwm_ready = false;
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static uint8_t ledpwm_slot_get(uint8_t led);
+static void ledpwm_dma_stop(uint8_t slot);
+static uint8_t ledpwm_level(const uint16_t *lut, uint16_t cnv);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+void LEDPWM_Init(void)
+{
+    uint8_t i;
+
+    if (ledpwm_ready) {
+        return;
+    }
+
+    for (i = 0U; i <= MAX_LED; i++) {
+        ledpwm_slot_of[i] = LEDPWM_NO_SLOT;
+    }
+
+    DMA_Init();
+    FTM_Init(LEDPWM_FTM, 0U, LEDPWM_PERIOD - 1U);
+    ledpwm_ready = true;
+}
+
+
+bool LEDPWM_Attach(uint8_t led)
+{
+    ledpwm_slot *slot = NULL;
+    uint8_t i, ftm, ch;
+
+    LEDPWM_Init();
+
+    if ((led == 0U) || (led > MAX_LED) || (ledpwm_slot_of[led] != LEDPWM_NO_SLOT)) {
+        return false;
+    }
+
+    for (i = 0U; i < LEDPWM_MAX; i++) {
+        if (ledpwm_table[i].led == 0U) {
+            slot = &ledpwm_table[i];
+            break;
+        }
+    }
+
+    /* Only FTM1/FTM2 channels have their own DMA request, the pin stays a
+       GPIO unless it is on LEDPWM_FTM */
+    if (slot == NULL || !FTM_PinFind(LED_GetPin(led), &ftm, &ch) || ftm != LEDPWM_FTM) {
+        return false;
+    }
+    (void)FTM_PwmInit(LED_GetPin(led), LED_IsActiveLow(led), &ftm, &ch);
+
+    slot->led = led;
+    slot->ch = ch;
+    slot->lut = ledpwm_gamma;
+    ledpwm_slot_of[led] = i;
+
+    /* Channel match requests DMA instead of an interrupt */
+    FTMX[ftm]->CONTROLS[ch].CnSC |= FTM_CnSC_CHIE_MASK | FTM_CnSC_DMA_MASK;
+    DMA_ChannelMux(DMA_CH_LEDPWM_DIV + i, (dma_request_source_t)(EDMA_REQ_FTM1_CHANNEL_0 + ch), false);
+
+    return true;
+}
+
+
+void LEDPWM_Set(uint8_t led, uint8_t level)
+{
+    uint8_t i = ledpwm_slot_get(led);
+
+    if (i == LEDPWM_NO_SLOT) {
+        return;
+    }
+
+    ledpwm_dma_stop(i);
+    ledpwm_table[i].lut = ledpwm_gamma;
+    FTMX[LEDPWM_FTM]->CONTROLS[ledpwm_table[i].ch].CnV = ledpwm_gamma[level];
+}
+
+
+void LEDPWM_Fade(uint8_t led, uint8_t level, uint16_t ms, ledpwm_curve curve)
+{
+    const uint16_t *lut = (curve == LEDPWM_EXP) ? ledpwm_exp : ledpwm_gamma;
+    uint8_t i = ledpwm_slot_get(led);
+    ledpwm_slot *slot;
+    uint32_t steps, div;
+    uint8_t from;
+    dma_tcd tcd;
+
+    if (i == LEDPWM_NO_SLOT) {
+        return;
+    }
+    slot = &ledpwm_table[i];
+
+    ledpwm_dma_stop(i);
+
+    /* Start from the level shown now, on the new curve */
+    from = ledpwm_level(lut, (uint16_t)FTMX[LEDPWM_FTM]->CONTROLS[slot->ch].CnV);
+    slot->lut = lut;
+    steps = (from > level) ? (uint32_t)(from - level) : (uint32_t)(level - from);
+
+    if (steps == 0U || ms == 0U) {
+        FTMX[LEDPWM_FTM]->CONTROLS[slot->ch].CnV = lut[level];
+        return;
+    }
+
+    div = ((uint32_t)ms * LEDPWM_HZ) / (1000U * steps);
+    div = (div == 0U) ? 1U : ((div > LEDPWM_DIV_MAX) ? LEDPWM_DIV_MAX : div);
+
+    /* Hold: copy the final entry forever */
+    slot->hold.saddr = (uint32_t)&lut[level];
+    slot->hold.soff = 0;
+    slot->hold.attr = DMA_ATTR(DMA_SIZE_16BIT, DMA_SIZE_16BIT);
+    slot->hold.nbytes = sizeof(uint16_t);
+    slot->hold.slast = 0;
+    slot->hold.daddr = (uint32_t)&FTMX[LEDPWM_FTM]->CONTROLS[slot->ch].CnV;
+    slot->hold.doff = 0;
+    slot->hold.citer = 1U;
+    slot->hold.dlast_sga = (int32_t)&slot->hold;
+    slot->hold.csr = DMA_TCD_CSR_ESG_MASK;
+    slot->hold.biter = 1U;
+
+    /* Writer: one entry per link, then the hold descriptor */
+    tcd = slot->hold;
+    tcd.saddr = (uint32_t)&lut[(from < level) ? (from + 1U) : (from - 1U)];
+    tcd.soff = (from < level) ? (int16_t)sizeof(uint16_t) : -(int16_t)sizeof(uint16_t);
+    tcd.citer = (uint16_t)steps;
+    tcd.biter = (uint16_t)steps;
+    DMA_TcdLoad(DMA_CH_LEDPWM_WR + i, &tcd);
+
+    /* Divider: one dummy transfer per PWM period, link to the writer every div */
+    tcd.saddr = (uint32_t)&ledpwm_dummy;
+    tcd.soff = 0;
+    tcd.attr = DMA_ATTR(DMA_SIZE_32BIT, DMA_SIZE_32BIT);
+    tcd.nbytes = sizeof(uint32_t);
+    tcd.slast = 0;
+    tcd.daddr = (uint32_t)&ledpwm_dummy;
+    tcd.doff = 0;
+    tcd.citer = (uint16_t)div;
+    tcd.dlast_sga = 0;
+    tcd.csr = DMA_TCD_CSR_MAJORELINK_MASK | DMA_TCD_CSR_MAJORLINKCH(DMA_CH_LEDPWM_WR + i);
+    tcd.biter = (uint16_t)div;
+    DMA_TcdLoad(DMA_CH_LEDPWM_DIV + i, &tcd);
+
+    DMA_ChannelStart(DMA_CH_LEDPWM_DIV + i);
+}
+
+
+uint8_t LEDPWM_GetLevel(uint8_t led)
+{
+    uint8_t i = ledpwm_slot_get(led);
+
+    if (i == LEDPWM_NO_SLOT) {
+        return 0U;
+    }
+
+    return ledpwm_level(ledpwm_table[i].lut, (uint16_t)FTMX[LEDPWM_FTM]->CONTROLS[ledpwm_table[i].ch].CnV);
+}
+
+
+void Test_LEDPWM(void)
+{
+    uint8_t led;
+
+    LEDPWM_Init();
+    for (led = 3U; led <= 5U; led++) {
+        LEDPWM_Attach(led);
+    }
+
+    while(1)
+    {
+        /* Same fade on the three curves side by side, the CPU only waits */
+        LEDPWM_Fade(3U, LEDPWM_LEVEL_MAX, 1500U, LEDPWM_LINEAR);
+        LEDPWM_Fade(4U, LEDPWM_LEVEL_MAX, 1500U, LEDPWM_EXP);
+        LEDPWM_Fade(5U, LEDPWM_LEVEL_MAX, 300U, LEDPWM_LINEAR);
+        delay(2000);
+
+        LEDPWM_Fade(3U, 0U, 1500U, LEDPWM_LINEAR);
+        LEDPWM_Fade(4U, 0U, 1500U, LEDPWM_EXP);
+        LEDPWM_Fade(5U, 0U, 3000U, LEDPWM_LINEAR);
+        delay(3500);
+    }
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Get the slot of a LED
+ * @param: led: number of LED
+ * @return: slot index, LEDPWM_NO_SLOT if the LED has no PWM
+ */
+static uint8_t ledpwm_slot_get(uint8_t led)
+{
+    if ((led == 0U) || (led > MAX_LED)) {
+        return LEDPWM_NO_SLOT;
+    }
+
+    return ledpwm_slot_of[led];
+}
+
+
+/*
+ * @brief: Stop the fade of a slot, CnV keeps the last written entry
+ * @param: slot: slot index
+ */
+static void ledpwm_dma_stop(uint8_t slot)
+{
+    DMA_ChannelStop(DMA_CH_LEDPWM_DIV + slot);
+
+    /* A link started just before the stop must finish before the reload */
+    while (DMA->TCD[DMA_CH_LEDPWM_DIV + slot].CSR & DMA_TCD_CSR_ACTIVE_MASK);
+    while (DMA->TCD[DMA_CH_LEDPWM_WR + slot].CSR & DMA_TCD_CSR_ACTIVE_MASK);
+}
+
+
+/*
+ * @brief: Find the level of a duty on a curve
+ * @param: lut: curve
+ * @param: cnv: duty in FTM ticks
+ * @return: first level whose duty is not below cnv
+ */
+static uint8_t ledpwm_level(const uint16_t *lut, uint16_t cnv)
+{
+    uint16_t lo = 0U;
+    uint16_t hi = LEDPWM_LEVEL_MAX;
+    uint16_t mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2U;
+        if (lut[mid] < cnv) {
+            lo = mid + 1U;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    return (uint8_t)lo;
+}
@@ -0,0 +1,281 @@
+/*
+ * =============================================================================
+ * File Name    : LOGIC.c
+ * Project      : S32K144_basic
+ * Module       : Logic Analyzer Module
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   On-chip logic analyzer for the S32K144. Every sample is a copy of the
+ *   whole PDIR register of one port plus a timestamp of the LPIT time base,
+ *   written to a RAM buffer by two linked eDMA channels with no CPU work.
+ *
+ *   Trigger modes:
+ *     - Edge  : pins configured with rising_DMA/falling_DMA/either_down_DMA
+ *               request one sample on each edge
+ *     - Timer : LPIT channel LPIT_CH_LOGIC requests samples at a fixed rate
+ *
+ *   LOGIC_Dump() prints the buffer as text, tools/la2vcd.py converts it to VCD.
+ *
+ * Dependencies :
+ *   - GPIO driver
+ *   - eDMA driver (channels DMA_CH_LOGIC_PORT and DMA_CH_LOGIC_TIME)
+ *   - LPIT driver (time base and LPIT_CH_LOGIC)
+ *
+ * Configuration :
+ *   - LOGIC_MAX_SAMPLES: maximum capture length
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "LOGIC.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+/* Samples per scatter/gather TCD, the linked major loop count is 9 bits wide */
+#define LOGIC_BLOCK                    256U
+#define LOGIC_TCD_NUM                  ((LOGIC_MAX_SAMPLES + LOGIC_BLOCK - 1U) / LOGIC_BLOCK)
+
+#define LOGIC_PORT_NONE                0xFFU
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+/* Scatter/gather chain of the PDIR channel */
+static dma_tcd logic_tcd[LOGIC_TCD_NUM];
+
+static uint8_t logic_port = LOGIC_PORT_NONE;
+static uint32_t logic_mask;
+static uint8_t logic_cfg[32];
+static logic_sample *logic_buff;
+static uint16_t logic_len;
+static uint32_t logic_rate;
+static bool logic_started = false;                              // Stop has something to undo
+static volatile logic_state logic_status = LOGIC_IDLE;
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static void logic_pins_request(bool enable);
+static void logic_done(uint8_t ch, void *ctx);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+void LOGIC_PinAdd(PTXn_e ptx_n, exti_cfg cfg)
+{
+    if (logic_port == LOGIC_PORT_NONE) {
+        logic_port = PTX(ptx_n);
+    }
+
+    if (logic_port == PTX(ptx_n)) {
+        GPIO_PinInit(ptx_n, GPI, 0);
+        logic_mask |= (1UL << PTn(ptx_n));
+        logic_cfg[PTn(ptx_n)] = (uint8_t)cfg;
+    }
+}
+
+
+bool LOGIC_Start(uint32_t rate_hz, logic_sample *buff, uint16_t len)
+{
+    dma_tcd time_tcd;
+    uint16_t count;
+    uint8_t k;
+
+    if ((logic_port == LOGIC_PORT_NONE) || (buff == NULL) || (len == 0U) ||
+        (len > LOGIC_MAX_SAMPLES) || (rate_hz > LPIT_CLK_HZ) ||
+        (logic_status == LOGIC_RUNNING)) {
+        return false;
+    }
+
+    LPIT_Init();
+    DMA_Init();
+
+    logic_buff = buff;
+    logic_len = len;
+    logic_rate = rate_hz;
+
+    /* PDIR channel: one TCD per block, every sample links the time channel */
+    for (k = 0U; (k * LOGIC_BLOCK) < len; k++) {
+        count = ((len - (k * LOGIC_BLOCK)) > LOGIC_BLOCK) ? LOGIC_BLOCK : (len - (k * LOGIC_BLOCK));
+
+        logic_tcd[k].saddr = (uint32_t)&GPIOX[logic_port]->PDIR;
+        logic_tcd[k].soff = 0;
+        logic_tcd[k].attr = DMA_ATTR(DMA_SIZE_32BIT, DMA_SIZE_32BIT);
+        logic_tcd[k].nbytes = sizeof(uint32_t);
+        logic_tcd[k].slast = 0;
+        logic_tcd[k].daddr = (uint32_t)&buff[k * LOGIC_BLOCK].port;
+        logic_tcd[k].doff = sizeof(logic_sample);
+        logic_tcd[k].citer = DMA_ITER_LINK(DMA_CH_LOGIC_TIME, count);
+        logic_tcd[k].biter = logic_tcd[k].citer;
+        logic_tcd[k].csr = DMA_TCD_CSR_MAJORELINK_MASK
+                         | DMA_TCD_CSR_MAJORLINKCH(DMA_CH_LOGIC_TIME);
+
+        if (((k + 1U) * LOGIC_BLOCK) < len) {
+            logic_tcd[k].dlast_sga = (int32_t)&logic_tcd[k + 1U];
+            logic_tcd[k].csr |= DMA_TCD_CSR_ESG_MASK;
+        }
+        else {
+            logic_tcd[k].dlast_sga = 0;
+            logic_tcd[k].csr |= DMA_TCD_CSR_DREQ_MASK;
+        }
+    }
+
+    /* Time channel: started only by the link, completes after the last sample */
+    time_tcd.saddr = (uint32_t)&LPIT0->TMR[LPIT_CH_TIMESTAMP].CVAL;
+    time_tcd.soff = 0;
+    time_tcd.attr = DMA_ATTR(DMA_SIZE_32BIT, DMA_SIZE_32BIT);
+    time_tcd.nbytes = sizeof(uint32_t);
+    time_tcd.slast = 0;
+    time_tcd.daddr = (uint32_t)&buff[0].time;
+    time_tcd.doff = sizeof(logic_sample);
+    time_tcd.citer = len;
+    time_tcd.biter = len;
+    time_tcd.dlast_sga = 0;
+    time_tcd.csr = DMA_TCD_CSR_INTMAJOR_MASK | DMA_TCD_CSR_DREQ_MASK;
+
+    DMA_TcdLoad(DMA_CH_LOGIC_TIME, &time_tcd);
+    DMA_ChannelAttach(DMA_CH_LOGIC_TIME, logic_done, NULL);
+    DMA_TcdLoad(DMA_CH_LOGIC_PORT, &logic_tcd[0]);
+
+    logic_status = LOGIC_RUNNING;
+    logic_started = true;
+
+    if (rate_hz == LOGIC_RATE_EDGE) {
+        /* The port request clears the pin flag when the transfer is done */
+        DMA_ChannelMux(DMA_CH_LOGIC_PORT, (dma_request_source_t)(EDMA_REQ_PORTA + logic_port), false);
+        DMA_ChannelStart(DMA_CH_LOGIC_PORT);
+        logic_pins_request(true);
+    }
+    else {
+        /* Always enabled source gated by the LPIT channel of the same number */
+        LPIT_ChannelInit(LPIT_CH_LOGIC, LPIT_CLK_HZ / rate_hz, NULL, NULL);
+        DMA_ChannelMux(DMA_CH_LOGIC_PORT, EDMA_REQ_DMAMUX_ALWAYS_ENABLED0, true);
+        DMA_ChannelStart(DMA_CH_LOGIC_PORT);
+        LPIT_ChannelStart(LPIT_CH_LOGIC);
+    }
+
+    return true;
+}
+
+
+void LOGIC_Stop(void)
+{
+    /* Only undo what LOGIC_Start() set up, the port may not even be known */
+    if (!logic_started) {
+        return;
+    }
+    logic_started = false;
+
+    DMA_ChannelStop(DMA_CH_LOGIC_PORT);
+    DMA_ChannelMux(DMA_CH_LOGIC_PORT, EDMA_REQ_DISABLED, false);
+
+    if (logic_rate == LOGIC_RATE_EDGE) {
+        logic_pins_request(false);
+    }
+    else {
+        LPIT_ChannelStop(LPIT_CH_LOGIC);
+    }
+
+    if (logic_status == LOGIC_RUNNING) {
+        logic_status = LOGIC_IDLE;
+    }
+}
+
+
+logic_state LOGIC_GetState(void)
+{
+    return logic_status;
+}
+
+
+uint16_t LOGIC_GetCount(void)
+{
+    if (logic_status == LOGIC_DONE) {
+        return logic_len;
+    }
+    if (logic_status == LOGIC_RUNNING) {
+        return (logic_len - DMA_GetCiter(DMA_CH_LOGIC_TIME, false));
+    }
+    return 0U;
+}
+
+
+void LOGIC_Dump(void)
+{
+    const char names[] = { 'A', 'B', 'C', 'D', 'E' };
+    uint16_t count = LOGIC_GetCount();
+    uint16_t i;
+
+    if ((logic_buff == NULL) || (logic_port == LOGIC_PORT_NONE)) {
+        return;
+    }
+
+    printf("#LOGIC port=%c clock=%lu mask=%08lx samples=%u\n", names[logic_port],
+           (unsigned long)LPIT_CLK_HZ, (unsigned long)logic_mask, count);
+    for (i = 0U; i < count; i++) {
+        /* The time base is a down counter */
+        printf("%08lx %08lx\n", (unsigned long)(~logic_buff[i].time),
+               (unsigned long)logic_buff[i].port);
+    }
+    printf("#END\n");
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Enable or disable the DMA request of the watched pins
+ * @param: enable: true to use the configured edge, false to disable
+ */
+static void logic_pins_request(bool enable)
+{
+    PORT_MemMapPtr port = PORTX[logic_port];
+    uint8_t ptn;
+
+    for (ptn = 0U; ptn < 32U; ptn++) {
+        if (logic_mask & (1UL << ptn)) {
+            port->PCR[ptn] = (port->PCR[ptn] & ~PORT_PCR_IRQC_MASK)
+                           | PORT_PCR_IRQC(enable ? logic_cfg[ptn] : 0U);
+        }
+    }
+    port->ISFR = logic_mask;
+}
+
+/*
+ * @brief: Major loop of the time channel, the buffer is full
+ */
+static void logic_done(uint8_t ch, void *ctx)
+{
+    (void)ch;
+    (void)ctx;
+
+    logic_status = LOGIC_DONE;
+    LOGIC_Stop();
+}
@@ -0,0 +1,319 @@
+/*
+ * =============================================================================
+ * File Name    : PCM.c
+ * Project      : S32K144_basic
+ * Module       : PCM Playback Module
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   FTM0 ch1 (buzzer) runs edge aligned PWM with a period of
+ *   FTM_CLK_HZ / (rate * PCM_OVERSAMPLE). FTM0 ch0 is an output compare with
+ *   no pin at CnV = 0, its flag requests DMA_CH_PCM at the start of every
+ *   period. The channel copies the next CnV word of a circular buffer of two
+ *   halves into ch1 CnV, which the FTM loads at the end of the period.
+ *
+ *   The half and major loop interrupts refill the half that was just sent:
+ *   the source gives PCM_SAMPLES 8-bit samples, scaled to the period and
+ *   repeated PCM_OVERSAMPLE times. When the source ends, the last half is
+ *   padded with silence and the channel stops after it.
+ *
+ * Dependencies :
+ *   - FTM driver
+ *   - DMA driver
+ *
+ * Configuration :
+ *   - See PCM.h
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "PCM.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define PCM_TRIG_CH                    0U      // FTM0 ch0, DMA request only
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+/* One period of a sine, full 8-bit range */
+const uint8_t pcm_sine[64] = {
+    128, 140, 153, 165, 177, 188, 199, 209, 218, 226, 234, 240, 245, 250, 253, 254,
+    255, 254, 253, 250, 245, 240, 234, 226, 218, 209, 199, 188, 177, 165, 153, 140,
+    128, 116, 103,  91,  79,  68,  57,  47,  38,  30,  22,  16,  11,   6,   3,   2,
+      1,   2,   3,   6,  11,  16,  22,  30,  38,  47,  57,  68,  79,  91, 103, 116
+};
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+static uint8_t pcm_ch;
+static uint16_t pcm_period;                             // PWM period in ticks
+static uint16_t pcm_buf[2][PCM_HALF_LEN];               // Read by the DMA
+static uint8_t pcm_samples[PCM_SAMPLES];
+static pcm_source pcm_src = NULL;
+static void *pcm_src_ctx = NULL;
+static volatile bool pcm_busy = false;
+static uint8_t pcm_end = 0U;                            // Halves to play after the source ended
+
+/* Flash source */
+static const uint8_t *pcm_data = NULL;
+static uint32_t pcm_left = 0U;
+
+/* Test generator */
+static uint32_t pcm_phase = 0U;
+static uint32_t pcm_step = 0U;
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static bool pcm_fill(uint8_t half);
+static void pcm_dma_done(uint8_t ch, void *ctx);
+static uint16_t pcm_flash(uint8_t *samples, uint16_t count, void *ctx);
+static uint16_t pcm_test_sine(uint8_t *samples, uint16_t count, void *ctx);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+void PCM_Init(void)
+{
+    uint8_t ftm;
+    dma_tcd tcd = { 0 };
+
+    FTM_Init(BUZZ_FTM, 0U, 0xFFFFU);
+    FTM_PwmInit(BUZZ_PIN, false, &ftm, &pcm_ch);
+
+    /* Circular buffer to ch1 CnV, one word per request */
+    tcd.saddr = (uint32_t)&pcm_buf[0][0];
+    tcd.soff = (int16_t)sizeof(uint16_t);
+    tcd.attr = DMA_ATTR(DMA_SIZE_16BIT, DMA_SIZE_16BIT);
+    tcd.nbytes = sizeof(uint16_t);
+    tcd.slast = -(int32_t)sizeof(pcm_buf);
+    tcd.daddr = (uint32_t)&FTMX[BUZZ_FTM]->CONTROLS[pcm_ch].CnV;
+    tcd.doff = 0;
+    tcd.citer = 2U * PCM_HALF_LEN;
+    tcd.biter = 2U * PCM_HALF_LEN;
+    tcd.csr = DMA_TCD_CSR_INTHALF_MASK | DMA_TCD_CSR_INTMAJOR_MASK;
+
+    DMA_Init();
+    DMA_TcdLoad(DMA_CH_PCM, &tcd);
+    DMA_ChannelMux(DMA_CH_PCM, EDMA_REQ_FTM0_OR_CH0_CH7, false);
+    DMA_ChannelAttach(DMA_CH_PCM, pcm_dma_done, NULL);
+}
+
+
+bool PCM_Play(const uint8_t *data, uint32_t len, uint16_t rate_hz)
+{
+    PCM_Stop();
+
+    pcm_data = data;
+    pcm_left = len;
+
+    return PCM_Stream(rate_hz, pcm_flash, NULL);
+}
+
+
+bool PCM_Stream(uint16_t rate_hz, pcm_source source, void *ctx)
+{
+    FTM_Type *base = FTMX[BUZZ_FTM];
+
+    if (rate_hz < PCM_RATE_MIN || rate_hz > PCM_RATE_MAX || source == NULL) {
+        return false;
+    }
+
+    BUZZ_Stop();
+    PCM_Stop();
+
+    pcm_src = source;
+    pcm_src_ctx = ctx;
+    pcm_period = (uint16_t)(FTM_CLK_HZ / ((uint32_t)rate_hz * PCM_OVERSAMPLE));
+
+    /* Both halves are ready before the first request */
+    pcm_end = 0U;
+    if (!pcm_fill(0U)) {
+        pcm_end = 1U;
+        for (uint16_t i = 0; i < PCM_HALF_LEN; i++) {
+            pcm_buf[1][i] = pcm_period / 2U;
+        }
+    }
+    else if (!pcm_fill(1U)) {
+        pcm_end = 2U;
+    }
+
+    DMA->TCD[DMA_CH_PCM].SADDR = (uint32_t)&pcm_buf[0][0];
+    DMA->TCD[DMA_CH_PCM].CITER.ELINKNO = 2U * PCM_HALF_LEN;
+    pcm_busy = true;
+    DMA_ChannelStart(DMA_CH_PCM);
+
+    /* The PWM restarts with the new period, then ch0 requests every period */
+    FTM_PwmPeriod(BUZZ_FTM, pcm_ch, 0U, (uint16_t)(pcm_period - 1U), pcm_period / 2U);
+    base->CONTROLS[PCM_TRIG_CH].CnV = 0U;
+    base->CONTROLS[PCM_TRIG_CH].CnSC = FTM_CnSC_MSA_MASK | FTM_CnSC_CHIE_MASK | FTM_CnSC_DMA_MASK;
+
+    return true;
+}
+
+
+void PCM_Stop(void)
+{
+    FTMX[BUZZ_FTM]->CONTROLS[PCM_TRIG_CH].CnSC = 0U;
+    DMA_ChannelStop(DMA_CH_PCM);
+    while (DMA->TCD[DMA_CH_PCM].CSR & DMA_TCD_CSR_ACTIVE_MASK);
+
+    FTMX[BUZZ_FTM]->CONTROLS[pcm_ch].CnV = 0U;
+    pcm_busy = false;
+}
+
+
+bool PCM_IsBusy(void)
+{
+    return pcm_busy;
+}
+
+
+void Test_PCM(void)
+{
+    PCM_Init();
+
+    /* 440 Hz sine for 1 s: 32-bit phase, the top 6 bits index the table */
+    pcm_step = (uint32_t)((440ULL << 32) / PCM_RATE_MAX);
+    pcm_phase = 0U;
+    PCM_Stream(PCM_RATE_MAX, pcm_test_sine, NULL);
+    delay(1000);
+    PCM_Stop();
+
+    /* Sweep up one octave, the CPU is free while the DMA plays */
+    for (uint32_t f = 440U; f <= 880U; f += 10U) {
+        pcm_step = (uint32_t)(((uint64_t)f << 32) / PCM_RATE_MAX);
+        if (!PCM_IsBusy()) {
+            PCM_Stream(PCM_RATE_MAX, pcm_test_sine, NULL);
+        }
+        delay(20);
+    }
+    PCM_Stop();
+
+    /* 100 periods of the table from flash, 250 Hz at 16 kHz */
+    for (uint8_t i = 0; i < 100U; i++) {
+        PCM_Play(pcm_sine, sizeof(pcm_sine), PCM_RATE_MAX);
+        while (PCM_IsBusy());
+    }
+}
+
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Fill half of the buffer from the source
+ * @param: half: 0 or 1
+ * @return: false if the source has ended, the rest is silence
+ */
+static bool pcm_fill(uint8_t half)
+{
+    uint16_t *out = pcm_buf[half];
+    uint16_t count = pcm_src(pcm_samples, PCM_SAMPLES, pcm_src_ctx);
+    uint16_t cnv;
+
+    for (uint16_t i = 0; i < PCM_SAMPLES; i++) {
+        cnv = (uint16_t)(((uint32_t)((i < count) ? pcm_samples[i] : PCM_SILENCE) * pcm_period) >> 8);
+        for (uint8_t n = 0; n < PCM_OVERSAMPLE; n++) {
+            *out++ = cnv;
+        }
+    }
+
+    return (count >= PCM_SAMPLES);
+}
+
+
+/*
+ * @brief: Half or major loop of the DMA channel, refill the half just sent
+ * @param: ch: DMA channel
+ * @param: ctx: not used
+ */
+static void pcm_dma_done(uint8_t ch, void *ctx)
+{
+    /* After the half interrupt CITER is at most PCM_HALF_LEN */
+    uint8_t half = (DMA_GetCiter(ch, false) > PCM_HALF_LEN) ? 1U : 0U;
+
+    (void)ctx;
+
+    if (pcm_end == 0U) {
+        if (!pcm_fill(half)) {
+            pcm_end = 2U;
+        }
+    }
+    else if (--pcm_end != 0U) {
+        for (uint16_t i = 0; i < PCM_HALF_LEN; i++) {
+            pcm_buf[half][i] = pcm_period / 2U;
+        }
+    }
+    else {
+        PCM_Stop();
+    }
+}
+
+
+/*
+ * @brief: Source of PCM_Play(), copies the flash samples
+ * @param: samples: buffer to fill
+ * @param: count: samples wanted
+ * @param: ctx: not used
+ * @return: samples copied
+ */
+static uint16_t pcm_flash(uint8_t *samples, uint16_t count, void *ctx)
+{
+    (void)ctx;
+
+    if (count > pcm_left) {
+        count = (uint16_t)pcm_left;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        samples[i] = *pcm_data++;
+    }
+    pcm_left -= count;
+
+    return count;
+}
+
+
+/*
+ * @brief: Source of Test_PCM(), sine of the table with a phase accumulator
+ * @param: samples: buffer to fill
+ * @param: count: samples wanted
+ * @param: ctx: not used
+ * @return: count, never ends
+ */
+static uint16_t pcm_test_sine(uint8_t *samples, uint16_t count, void *ctx)
+{
+    (void)ctx;
+
+    for (uint16_t i = 0; i < count; i++) {
+        samples[i] = pcm_sine[pcm_phase >> 26];
+        pcm_phase += pcm_step;
+    }
+
+    return count;
+}
@@ -0,0 +1,380 @@
+/*
+ * =============================================================================
+ * File Name    : RTTTL.c
+ * Project      : S32K144_basic
+ * Module       : RTTTL Melody Parser
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   The parser is a state machine over the three sections of a song:
+ *     name : defaults (d=, o=, b=) : notes separated by commas
+ *   A note is [duration] letter [#] [.] [octave] [.], "p" is a pause. When a
+ *   note ends it is converted to a packed buzz_note (tempo and dots are
+ *   resolved here, outside the playback interrupt) and queued. If the queue
+ *   is full the note is kept and the next char is refused until it fits.
+ *
+ * Dependencies :
+ *   - BUZZ module
+ *   - UART driver
+ *
+ * Configuration :
+ *   - See RTTTL.h
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "RTTTL.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define RTTTL_XON                      0x11U
+#define RTTTL_XOFF                     0x13U
+#define RTTTL_MAX_TICKS                0x3FFU
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+typedef enum {
+    RTTTL_NAME,                         // Up to the first ':'
+    RTTTL_KEY,                          // d, o or b
+    RTTTL_VALUE,                        // Digits after '='
+    RTTTL_NOTES,                        // Up to the end of the line
+} rtttl_section;
+
+typedef struct {
+    rtttl_section section;
+    char key;
+    uint16_t value;
+    uint8_t def_dur;                    // Defaults of the song
+    uint8_t def_oct;
+    uint16_t bpm;
+    uint8_t dur;                        // Note being parsed, 0: default
+    uint8_t oct;
+    int8_t semi;                        // -1: no letter yet, 12: pause
+    bool sharp;
+    bool dotted;
+    bool pending;                       // note waits for room in the queue
+    buzz_note note;
+} rtttl_parser;
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+const char rtttl_demo[] = "Simpsons:d=4,o=5,b=160:c.6,e6,f#6,8a6,g.6,e6,c6,8a,8f#,8f#,8f#,2g";
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+static rtttl_parser rtttl;
+static const char *rtttl_text = NULL;
+
+/* UART receive buffer, written by the interrupt */
+static LPUART_Type *rtttl_uart = NULL;
+static uint8_t rtttl_rx[RTTTL_RX_LEN];
+static volatile uint8_t rtttl_rx_head = 0U;
+static volatile uint8_t rtttl_rx_tail = 0U;
+static volatile bool rtttl_xoff = false;
+static volatile uint32_t rtttl_lost = 0U;
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static void rtttl_note_start(void);
+static void rtttl_note_end(void);
+static void rtttl_uart_rx(uint8_t data, void *ctx);
+static uint8_t rtttl_rx_level(void);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+void RTTTL_Init(void)
+{
+    rtttl.section = RTTTL_NAME;
+    rtttl.pending = false;
+}
+
+
+bool RTTTL_Putc(char c)
+{
+    static const int8_t semitone[7] = { 9, 11, 0, 2, 4, 5, 7 };     // a .. g
+
+    if (rtttl.pending) {
+        if (!BUZZ_Queue(rtttl.note)) {
+            return false;
+        }
+        rtttl.pending = false;
+    }
+
+    /* End of the song, only taken once the last note is queued */
+    if (c == '\0' || c == '\n' || c == '\r') {
+        if (rtttl.section == RTTTL_NOTES) {
+            rtttl_note_end();
+        }
+        rtttl.section = RTTTL_NAME;
+        return !rtttl.pending;
+    }
+
+    if (c >= 'A' && c <= 'Z') {
+        c = (char)(c - 'A' + 'a');
+    }
+
+    switch (rtttl.section) {
+    case RTTTL_NAME:
+        if (c == ':') {
+            rtttl.def_dur = 4U;
+            rtttl.def_oct = 6U;
+            rtttl.bpm = 63U;
+            rtttl.key = 0;
+            rtttl.section = RTTTL_KEY;
+        }
+        break;
+
+    case RTTTL_KEY:
+        if (c == 'd' || c == 'o' || c == 'b') {
+            rtttl.key = c;
+        }
+        else if (c == '=') {
+            rtttl.value = 0U;
+            rtttl.section = RTTTL_VALUE;
+        }
+        else if (c == ':') {
+            rtttl_note_start();
+        }
+        break;
+
+    case RTTTL_VALUE:
+        if (c >= '0' && c <= '9') {
+            rtttl.value = (uint16_t)(rtttl.value * 10U + (uint16_t)(c - '0'));
+        }
+        else if (c == ',' || c == ':') {
+            if (rtttl.value != 0U) {
+                if (rtttl.key == 'd') {
+                    rtttl.def_dur = (uint8_t)rtttl.value;
+                }
+                else if (rtttl.key == 'o') {
+                    rtttl.def_oct = (uint8_t)rtttl.value;
+                }
+                else if (rtttl.key == 'b') {
+                    rtttl.bpm = rtttl.value;
+                }
+            }
+            rtttl.key = 0;
+            rtttl.section = RTTTL_KEY;
+            if (c == ':') {
+                rtttl_note_start();
+            }
+        }
+        break;
+
+    case RTTTL_NOTES:
+        if (c >= '0' && c <= '9') {
+            if (rtttl.semi < 0) {
+                rtttl.dur = (uint8_t)(rtttl.dur * 10U + (uint8_t)(c - '0'));
+            }
+            else {
+                rtttl.oct = (uint8_t)(c - '0');
+            }
+        }
+        else if (c >= 'a' && c <= 'g') {
+            rtttl.semi = semitone[c - 'a'];
+        }
+        else if (c == 'h') {
+            rtttl.semi = 11;                                        // German B
+        }
+        else if (c == 'p') {
+            rtttl.semi = 12;
+        }
+        else if (c == '#' || c == '_') {
+            rtttl.sharp = true;
+        }
+        else if (c == '.') {
+            rtttl.dotted = true;
+        }
+        else if (c == ',') {
+            rtttl_note_end();
+            rtttl_note_start();
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return true;
+}
+
+
+void RTTTL_Play(const char *text)
+{
+    BUZZ_Stop();
+    RTTTL_Init();
+    rtttl_text = text;
+    RTTTL_Task();
+}
+
+
+void RTTTL_UartInit(LPUART_Type *base)
+{
+    rtttl_rx_head = 0U;
+    rtttl_rx_tail = 0U;
+    rtttl_xoff = false;
+    rtttl_lost = 0U;
+    rtttl_uart = base;
+
+    UART_RxAttach(base, rtttl_uart_rx, NULL);
+}
+
+
+void RTTTL_Task(void)
+{
+    /* Flash text first */
+    while (rtttl_text != NULL && RTTTL_Putc(*rtttl_text)) {
+        rtttl_text = (*rtttl_text != '\0') ? (rtttl_text + 1) : NULL;
+    }
+
+    /* Then the UART, only while no flash song is being parsed */
+    while (rtttl_text == NULL && rtttl_rx_tail != rtttl_rx_head) {
+        if (!RTTTL_Putc((char)rtttl_rx[rtttl_rx_tail])) {
+            break;
+        }
+        rtttl_rx_tail = (uint8_t)((rtttl_rx_tail + 1U) % RTTTL_RX_LEN);
+    }
+
+    if (rtttl_xoff && rtttl_rx_level() <= RTTTL_XON_LEVEL) {
+        rtttl_xoff = false;
+        UART_PutChar(rtttl_uart, RTTTL_XON);
+    }
+}
+
+
+uint32_t RTTTL_GetLost(void)
+{
+    return rtttl_lost;
+}
+
+
+void Test_RTTTL(void)
+{
+    RTTTL_Play(rtttl_demo);
+    RTTTL_UartInit(LPUART0);
+    printf("RTTTL: send songs on LPUART0, one per line (XON/XOFF)\n");
+
+    while(1)
+    {
+        RTTTL_Task();
+        __asm("WFI");
+    }
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Clear the fields of the next note
+ */
+static void rtttl_note_start(void)
+{
+    rtttl.section = RTTTL_NOTES;
+    rtttl.dur = 0U;
+    rtttl.oct = 0U;
+    rtttl.semi = -1;
+    rtttl.sharp = false;
+    rtttl.dotted = false;
+}
+
+
+/*
+ * @brief: Convert the parsed note and queue it
+ */
+static void rtttl_note_end(void)
+{
+    uint32_t num, den, ticks;
+    int16_t midi;
+    uint8_t index = 0U;
+    uint8_t dur = (rtttl.dur != 0U) ? rtttl.dur : rtttl.def_dur;
+
+    if (rtttl.semi < 0 || dur == 0U || rtttl.bpm == 0U) {
+        return;                                                     // Not a note
+    }
+
+    /* 1/dur of a whole note, the beat of b= is a quarter: 240000 / (b * dur) ms */
+    num = 240000UL * (rtttl.dotted ? 3U : 2U);
+    den = 2UL * rtttl.bpm * dur * BUZZ_TICK_MS;
+    ticks = (num + den / 2U) / den;
+    ticks = (ticks == 0U) ? 1U : ((ticks > RTTTL_MAX_TICKS) ? RTTTL_MAX_TICKS : ticks);
+
+    if (rtttl.semi != 12) {
+        midi = (int16_t)(12 * ((rtttl.oct != 0U ? rtttl.oct : rtttl.def_oct) + 1) + rtttl.semi + (rtttl.sharp ? 1 : 0));
+
+        /* Out of range notes are moved by octaves */
+        while (midi < (int16_t)BUZZ_MIDI_MIN) {
+            midi += 12;
+        }
+        while (midi > (int16_t)BUZZ_MIDI_MAX) {
+            midi -= 12;
+        }
+        index = BUZZ_MIDI(midi);
+    }
+
+    rtttl.note = BUZZ_NOTE(index, ticks);
+    rtttl.pending = !BUZZ_Queue(rtttl.note);
+}
+
+
+/*
+ * @brief: UART receive interrupt, stores the char and pauses the sender
+ * @param: data: received char
+ * @param: ctx: not used
+ */
+static void rtttl_uart_rx(uint8_t data, void *ctx)
+{
+    uint8_t next = (uint8_t)((rtttl_rx_head + 1U) % RTTTL_RX_LEN);
+
+    (void)ctx;
+
+    if (data == RTTTL_XON || data == RTTTL_XOFF) {
+        return;
+    }
+
+    if (next == rtttl_rx_tail) {
+        rtttl_lost++;
+        return;
+    }
+
+    rtttl_rx[rtttl_rx_head] = data;
+    rtttl_rx_head = next;
+
+    if (!rtttl_xoff && rtttl_rx_level() >= RTTTL_XOFF_LEVEL) {
+        rtttl_xoff = true;
+        UART_PutChar(rtttl_uart, RTTTL_XOFF);
+    }
+}
+
+
+/*
+ * @brief: Get the number of chars in the UART buffer
+ * @return: chars waiting to be parsed
+ */
+static uint8_t rtttl_rx_level(void)
+{
+    return (uint8_t)((rtttl_rx_head + RTTTL_RX_LEN - rtttl_rx_tail) % RTTTL_RX_LEN);
+}
@@ -0,0 +1,255 @@
+/*
+ * =============================================================================
+ * File Name    : S32K_DMA.c
+ * Project      : S32K144_basic
+ * Module       : eDMA / DMAMUX Driver
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Minimal driver for the 16-channel eDMA controller and its DMAMUX on the
+ *   NXP S32K144. Transfers are described with a software TCD that is copied to
+ *   the channel, or linked from another TCD in RAM for scatter/gather chains.
+ *
+ * Dependencies :
+ *   - None
+ *
+ * Configuration :
+ *   - Channels 0..3 can be triggered periodically by LPIT channels 0..3
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "S32K_DMA.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+typedef struct {
+    dma_callback callback;              // Function called from the interrupt
+    void *ctx;                          // User pointer given to the callback
+} dma_channel_entry;
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+static dma_channel_entry dma_table[DMA_CH_NUM];
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static void dma_irq_dispatch(uint8_t ch);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+void DMA_Init(void)
+{
+    /* eDMA clock (enabled after reset) and DMAMUX clock */
+    SIM->PLATCGC |= SIM_PLATCGC_CGCDMA_MASK;
+    PCC->PCCn[PCC_DMAMUX_INDEX] = PCC_PCCn_CGC_MASK;
+
+    /* Round robin arbitration, halt on error */
+    DMA->CR = DMA_CR_ERCA_MASK | DMA_CR_HOE_MASK;
+}
+
+
+void DMA_ChannelMux(uint8_t ch, dma_request_source_t source, bool periodic)
+{
+    /* The channel must be disabled before the source is changed */
+    DMAMUX->CHCFG[ch] = 0U;
+
+    if (source != EDMA_REQ_DISABLED) {
+        DMAMUX->CHCFG[ch] = DMAMUX_CHCFG_SOURCE(source)
+                          | DMAMUX_CHCFG_TRIG(periodic ? 1U : 0U)
+                          | DMAMUX_CHCFG_ENBL_MASK;
+    }
+}
+
+
+void DMA_TcdLoad(uint8_t ch, const dma_tcd *tcd)
+{
+    /* Clear CSR first so that a pending DONE does not start the channel */
+    DMA->TCD[ch].CSR = 0U;
+
+    DMA->TCD[ch].SADDR = tcd->saddr;
+    DMA->TCD[ch].SOFF = (uint16_t)tcd->soff;
+    DMA->TCD[ch].ATTR = tcd->attr;
+    DMA->TCD[ch].NBYTES.MLNO = tcd->nbytes;
+    DMA->TCD[ch].SLAST = (uint32_t)tcd->slast;
+    DMA->TCD[ch].DADDR = tcd->daddr;
+    DMA->TCD[ch].DOFF = (uint16_t)tcd->doff;
+    DMA->TCD[ch].CITER.ELINKNO = tcd->citer;
+    DMA->TCD[ch].DLASTSGA = (uint32_t)tcd->dlast_sga;
+    DMA->TCD[ch].BITER.ELINKNO = tcd->biter;
+    DMA->TCD[ch].CSR = tcd->csr;
+}
+
+
+void DMA_ChannelAttach(uint8_t ch, dma_callback callback, void *ctx)
+{
+    dma_table[ch].callback = callback;
+    dma_table[ch].ctx = ctx;
+
+    NVIC_EnableIRQ((IRQn_Type)(DMA0_IRQn + ch));
+}
+
+
+void DMA_ChannelStart(uint8_t ch)
+{
+    DMA->CDNE = ch;
+    DMA->SERQ = ch;
+}
+
+
+void DMA_ChannelStop(uint8_t ch)
+{
+    DMA->CERQ = ch;
+}
+
+
+uint16_t DMA_GetCiter(uint8_t ch, bool linked)
+{
+    uint16_t citer = DMA->TCD[ch].CITER.ELINKNO;
+
+    if (linked) {
+        return (citer & DMA_TCD_CITER_ELINKYES_CITER_LE_MASK);
+    }
+    return (citer & DMA_TCD_CITER_ELINKNO_CITER_MASK);
+}
+
+
+void DMA0_IRQHandler(void)
+{
+    dma_irq_dispatch(0U);
+}
+
+
+void DMA1_IRQHandler(void)
+{
+    dma_irq_dispatch(1U);
+}
+
+
+void DMA2_IRQHandler(void)
+{
+    dma_irq_dispatch(2U);
+}
+
+
+void DMA3_IRQHandler(void)
+{
+    dma_irq_dispatch(3U);
+}
+
+
+void DMA4_IRQHandler(void)
+{
+    dma_irq_dispatch(4U);
+}
+
+
+void DMA5_IRQHandler(void)
+{
+    dma_irq_dispatch(5U);
+}
+
+
+void DMA6_IRQHandler(void)
+{
+    dma_irq_dispatch(6U);
+}
+
+
+void DMA7_IRQHandler(void)
+{
+    dma_irq_dispatch(7U);
+}
+
+
+void DMA8_IRQHandler(void)
+{
+    dma_irq_dispatch(8U);
+}
+
+
+void DMA9_IRQHandler(void)
+{
+    dma_irq_dispatch(9U);
+}
+
+
+void DMA10_IRQHandler(void)
+{
+    dma_irq_dispatch(10U);
+}
+
+
+void DMA11_IRQHandler(void)
+{
+    dma_irq_dispatch(11U);
+}
+
+
+void DMA12_IRQHandler(void)
+{
+    dma_irq_dispatch(12U);
+}
+
+
+void DMA13_IRQHandler(void)
+{
+    dma_irq_dispatch(13U);
+}
+
+
+void DMA14_IRQHandler(void)
+{
+    dma_irq_dispatch(14U);
+}
+
+
+void DMA15_IRQHandler(void)
+{
+    dma_irq_dispatch(15U);
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Clear the channel interrupt and run its callback
+ * @param: ch: DMA channel (0..15)
+ */
+static void dma_irq_dispatch(uint8_t ch)
+{
+    DMA->CINT = ch;
+
+    if (dma_table[ch].callback != NULL) {
+        dma_table[ch].callback(ch, dma_table[ch].ctx);
+    }
+}
@@ -0,0 +1,731 @@
+/*
+ * =============================================================================
+ * File Name    : S32K_FTM.c
+ * Project      : S32K144_basic
+ * Module       : FlexTimer Driver
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Counter, pin mux and interrupt handling of the FlexTimer modules, plus the
+ *   input capture timestamping service.
+ *
+ *   The counter is extended to 64 bits by counting overflows. When an edge is
+ *   latched just after an overflow whose interrupt is still pending, the
+ *   channel interrupt (served first, lower IRQ number) sees TOF set and a small
+ *   CnV, and adds the missing overflow itself.
+ *
+ * Dependencies :
+ *   - S32K_DMA
+ *
+ * Configuration :
+ *   - SOSC running before FTM_Init() (CLOCK_Init())
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "S32K_FTM.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define FTM_PCS_SOSCDIV1               1U
+#define FTM_PCS_SIRCDIV1               2U      // Same 8 MHz, used in VLPR
+#define FTM_CLKS_EXTERNAL              3U      // Clock selected in the PCC
+#define FTM_IRQ_STRIDE                 6U      // 4 channel pairs + fault + overflow
+#define FTM_OVF_CH                     0xFFU   // Channel given to overflow callbacks
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+/* Pin routed to an FTM channel */
+typedef struct {
+    PTXn_e pin;
+    uint8_t ftm;
+    uint8_t ch;
+    uint8_t mux;                        // PCR MUX alternative
+} ftm_pin_entry;
+
+typedef struct {
+    ftm_callback callback;              // Function called on the channel flag
+    void *ctx;                          // User pointer given to the callback
+} ftm_channel_entry;
+
+/* Input capture channel */
+typedef struct {
+    bool used;
+    bool dma;                           // Latched values copied by DMA_CH_CAPTURE
+    PTXn_e pin;
+    uint8_t ftm;
+    uint8_t ch;
+    volatile uint64_t ring[FTM_CAPTURE_RING];
+    volatile uint8_t head;              // Written by the interrupt
+    volatile uint8_t tail;              // Written by FTM_CaptureRead()
+    volatile uint32_t lost;
+} ftm_capture_slot;
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+FTM_Type *const FTMX[FTM_NUM] = {FTM0, FTM1, FTM2, FTM3};
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+/* Only the pins checked on this board, add more from the IO signal table */
+static const ftm_pin_entry ftm_pin_table[] = {
+    {PTB12, 0U, 0U, 2U},
+    {PTB13, 0U, 1U, 2U},
+    {PTC0,  0U, 0U, 2U},
+    {PTC1,  0U, 1U, 2U},
+    {PTC2,  0U, 2U, 2U},
+    {PTC3,  0U, 3U, 2U},
+    {PTD15, 0U, 0U, 2U},
+    {PTD16, 0U, 1U, 2U},                // Buzzer
+    {PTD0,  0U, 2U, 2U},
+    {PTD1,  0U, 3U, 2U},
+    {PTA10, 1U, 4U, 2U},
+    {PTA11, 1U, 5U, 2U},                // LED3
+    {PTA12, 1U, 6U, 2U},                // LED4
+    {PTA13, 1U, 7U, 2U},                // LED5
+    {PTD2,  3U, 4U, 2U},                // KEYA
+    {PTD3,  3U, 5U, 2U},                // KEYC
+};
+
+static const uint8_t ftm_pcc_index[FTM_NUM] = {
+    PCC_FTM0_INDEX, PCC_FTM1_INDEX, PCC_FTM2_INDEX, PCC_FTM3_INDEX
+};
+
+static ftm_channel_entry ftm_ch_table[FTM_NUM][FTM_CH_NUM];
+static ftm_channel_entry ftm_ovf_table[FTM_NUM];
+static volatile uint32_t ftm_overflow[FTM_NUM];
+static uint32_t ftm_period[FTM_NUM];
+
+static ftm_capture_slot capture_table[FTM_CAPTURE_SLOTS];
+static volatile uint16_t capture_dma_buff[FTM_CAPTURE_DMA_LEN];
+static uint8_t capture_dma_tail;
+static ftm_capture_slot *capture_dma_slot = NULL;              // Slot using DMA_CH_CAPTURE
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static const ftm_pin_entry *ftm_pin_find(PTXn_e ptx_n);
+static void ftm_ch_dispatch(uint8_t ftm, uint8_t ch);
+static void ftm_ovf_dispatch(uint8_t ftm);
+static uint64_t ftm_extend(uint8_t ftm, uint32_t cnt);
+static void ftm_ovf_enable(uint8_t ftm);
+static ftm_capture_slot *ftm_capture_find(PTXn_e ptx_n);
+static void ftm_capture_isr(uint8_t ftm, uint8_t ch, void *ctx);
+static void ftm_capture_dma_drain(ftm_capture_slot *slot);
+static void ftm_clock_select(uint8_t ftm, clock_profile profile);
+static void ftm_clock_notifier(clock_event event, clock_profile profile, void *ctx);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+void FTM_Init(uint8_t ftm, uint8_t ps, uint16_t mod)
+{
+    FTM_Type *base = FTMX[ftm];
+
+    ftm_clock_select(ftm, CLOCK_GetProfile());
+    CLOCK_NotifierAttach(ftm_clock_notifier, NULL);
+
+    base->MODE = FTM_MODE_WPDIS_MASK;
+    base->SC = 0U;
+    base->CNTIN = 0U;
+    base->MOD = mod;
+    base->CNT = 0U;
+
+    ftm_overflow[ftm] = 0U;
+    ftm_period[ftm] = (uint32_t)mod + 1U;
+
+    base->SC = FTM_SC_CLKS(FTM_CLKS_EXTERNAL) | FTM_SC_PS(ps);
+}
+
+
+bool FTM_PinFind(PTXn_e ptx_n, uint8_t *ftm, uint8_t *ch)
+{
+    const ftm_pin_entry *entry = ftm_pin_find(ptx_n);
+
+    if (entry == NULL) {
+        return false;
+    }
+
+    *ftm = entry->ftm;
+    *ch = entry->ch;
+    return true;
+}
+
+
+bool FTM_PinMux(PTXn_e ptx_n, uint8_t *ftm, uint8_t *ch)
+{
+    const ftm_pin_entry *entry = ftm_pin_find(ptx_n);
+    uint8_t ptx, ptn;
+
+    if (entry == NULL) {
+        return false;
+    }
+
+    ptx = PTX(ptx_n);
+    ptn = PTn(ptx_n);
+    PCC->PCCn[PCC_PORTA_INDEX + ptx] = PCC_PCCn_CGC_MASK;
+    PORTX[ptx]->PCR[ptn] &= ~(uint32_t)PORT_PCR_MUX_MASK;
+    PORTX[ptx]->PCR[ptn] |= PORT_PCR_MUX(entry->mux);
+
+    *ftm = entry->ftm;
+    *ch = entry->ch;
+    return true;
+}
+
+
+bool FTM_PwmInit(PTXn_e ptx_n, bool low_true, uint8_t *ftm, uint8_t *ch)
+{
+    FTM_Type *base;
+
+    if (!FTM_PinMux(ptx_n, ftm, ch)) {
+        return false;
+    }
+    base = FTMX[*ftm];
+
+    /* Edge aligned PWM: high-true clears the output on match, low-true sets it */
+    base->CONTROLS[*ch].CnV = 0U;
+    base->CONTROLS[*ch].CnSC = FTM_CnSC_MSB_MASK | (low_true ? FTM_CnSC_ELSA_MASK : FTM_CnSC_ELSB_MASK);
+
+    /* CnV taken from its buffer at the end of every period */
+    base->PWMLOAD |= (1UL << *ch) | FTM_PWMLOAD_LDOK_MASK;
+    base->SC |= (FTM_SC_PWMEN0_MASK << *ch);
+
+    return true;
+}
+
+
+void FTM_PwmPeriod(uint8_t ftm, uint8_t ch, uint8_t ps, uint16_t mod, uint16_t cnv)
+{
+    FTM_Type *base = FTMX[ftm];
+    uint32_t sc = base->SC & ~(FTM_SC_CLKS_MASK | FTM_SC_PS_MASK);
+
+    /* MOD and CnV are written straight to the registers while the clock is off */
+    base->SC = sc;
+    base->MOD = mod;
+    base->CONTROLS[ch].CnV = cnv;
+    base->CNT = 0U;
+
+    ftm_period[ftm] = (uint32_t)mod + 1U;
+    base->SC = sc | FTM_SC_CLKS(FTM_CLKS_EXTERNAL) | FTM_SC_PS(ps);
+}
+
+
+void FTM_ChannelAttach(uint8_t ftm, uint8_t ch, ftm_callback callback, void *ctx)
+{
+    uint32_t primask;
+
+    DisableInterruptsSave(primask);
+    ftm_ch_table[ftm][ch].callback = callback;
+    ftm_ch_table[ftm][ch].ctx = ctx;
+    RestoreInterrupts(primask);
+
+    if (callback != NULL) {
+        NVIC_EnableIRQ((IRQn_Type)(FTM0_Ch0_Ch1_IRQn + ftm * FTM_IRQ_STRIDE + ch / 2U));
+    }
+}
+
+
+void FTM_OverflowAttach(uint8_t ftm, ftm_callback callback, void *ctx)
+{
+    uint32_t primask;
+
+    DisableInterruptsSave(primask);
+    ftm_ovf_table[ftm].callback = callback;
+    ftm_ovf_table[ftm].ctx = ctx;
+    RestoreInterrupts(primask);
+
+    ftm_ovf_enable(ftm);
+}
+
+
+uint64_t FTM_GetTime(uint8_t ftm)
+{
+    uint32_t primask;
+    uint64_t time;
+
+    DisableInterruptsSave(primask);
+    time = ftm_extend(ftm, FTMX[ftm]->CNT);
+    RestoreInterrupts(primask);
+
+    return time;
+}
+
+
+bool FTM_CaptureInit(PTXn_e ptx_n, ftm_capture_edge edge, bool dma)
+{
+    uint32_t primask;
+    ftm_capture_slot *slot = NULL;
+    uint8_t i, ftm, ch;
+    dma_tcd tcd;
+
+    for (i = 0U; i < FTM_CAPTURE_SLOTS; i++) {
+        if (capture_table[i].used) {
+            if (capture_table[i].pin == ptx_n || (dma && capture_table[i].dma)) {
+                return false;
+            }
+        }
+        else if (slot == NULL) {
+            slot = &capture_table[i];
+        }
+    }
+
+    if (slot == NULL || !FTM_PinFind(ptx_n, &ftm, &ch)) {
+        return false;
+    }
+
+    /* FTM0 and FTM3 have one DMA request for all their channels, PCM owns the FTM0 one */
+    if (dma && (ftm == 0U || ftm == 3U)) {
+        return false;
+    }
+
+    (void)FTM_PinMux(ptx_n, &ftm, &ch);
+
+    /* Overflows extend the latched values to 64 bits */
+    ftm_ovf_enable(ftm);
+
+    FTMX[ftm]->CONTROLS[ch].CnSC = 0U;
+
+    slot->pin = ptx_n;
+    slot->ftm = ftm;
+    slot->ch = ch;
+    slot->dma = dma;
+    slot->head = 0U;
+    slot->tail = 0U;
+    slot->lost = 0U;
+    slot->used = true;
+
+    if (dma) {
+        /* Circular buffer of raw CnV values, extended when they are read */
+        tcd.saddr = (uint32_t)&FTMX[ftm]->CONTROLS[ch].CnV;
+        tcd.soff = 0;
+        tcd.attr = DMA_ATTR(DMA_SIZE_16BIT, DMA_SIZE_16BIT);
+        tcd.nbytes = sizeof(uint16_t);
+        tcd.slast = 0;
+        tcd.daddr = (uint32_t)capture_dma_buff;
+        tcd.doff = sizeof(uint16_t);
+        tcd.citer = FTM_CAPTURE_DMA_LEN;
+        tcd.dlast_sga = -(int32_t)sizeof(capture_dma_buff);
+        tcd.csr = 0U;
+        tcd.biter = FTM_CAPTURE_DMA_LEN;
+
+        DMA_Init();
+        if (ftm == 1U) {
+            DMA_ChannelMux(DMA_CH_CAPTURE, (dma_request_source_t)(EDMA_REQ_FTM1_CHANNEL_0 + ch), false);
+        }
+        else {
+            DMA_ChannelMux(DMA_CH_CAPTURE, (dma_request_source_t)(EDMA_REQ_FTM2_CHANNEL_0 + ch), false);
+        }
+        DMA_TcdLoad(DMA_CH_CAPTURE, &tcd);
+        DMA_ChannelStart(DMA_CH_CAPTURE);
+
+        /* The overflow interrupt drains the buffer once per counter period */
+        DisableInterruptsSave(primask);
+        capture_dma_tail = 0U;
+        capture_dma_slot = slot;
+        RestoreInterrupts(primask);
+
+        FTMX[ftm]->CONTROLS[ch].CnSC = ((uint32_t)edge << FTM_CnSC_ELSA_SHIFT) |
+                                       FTM_CnSC_CHIE_MASK | FTM_CnSC_DMA_MASK;
+    }
+    else {
+        FTM_ChannelAttach(ftm, ch, ftm_capture_isr, slot);
+        FTMX[ftm]->CONTROLS[ch].CnSC = ((uint32_t)edge << FTM_CnSC_ELSA_SHIFT) | FTM_CnSC_CHIE_MASK;
+    }
+
+    return true;
+}
+
+
+void FTM_CaptureStop(PTXn_e ptx_n)
+{
+    uint32_t primask;
+    ftm_capture_slot *slot = ftm_capture_find(ptx_n);
+
+    if (slot == NULL) {
+        return;
+    }
+
+    FTMX[slot->ftm]->CONTROLS[slot->ch].CnSC = 0U;
+
+    if (slot->dma) {
+        DMA_ChannelStop(DMA_CH_CAPTURE);
+        DisableInterruptsSave(primask);
+        capture_dma_slot = NULL;
+        RestoreInterrupts(primask);
+    }
+    else {
+        FTM_ChannelAttach(slot->ftm, slot->ch, NULL, NULL);
+    }
+
+    slot->used = false;
+}
+
+
+bool FTM_CaptureRead(PTXn_e ptx_n, uint64_t *time)
+{
+    uint32_t primask;
+    ftm_capture_slot *slot = ftm_capture_find(ptx_n);
+    uint8_t tail;
+
+    if (slot == NULL) {
+        return false;
+    }
+
+    if (slot->dma) {
+        DisableInterruptsSave(primask);
+        ftm_capture_dma_drain(slot);
+        RestoreInterrupts(primask);
+    }
+
+    tail = slot->tail;
+    if (tail == slot->head) {
+        return false;
+    }
+
+    *time = slot->ring[tail];
+    slot->tail = (tail + 1U) & (FTM_CAPTURE_RING - 1U);
+
+    return true;
+}
+
+
+uint32_t FTM_CaptureGetLost(PTXn_e ptx_n)
+{
+    ftm_capture_slot *slot = ftm_capture_find(ptx_n);
+
+    return (slot != NULL) ? slot->lost : 0U;
+}
+
+
+void FTM0_Ch0_Ch1_IRQHandler(void)
+{
+    ftm_ch_dispatch(0U, 0U);
+}
+
+void FTM0_Ch2_Ch3_IRQHandler(void)
+{
+    ftm_ch_dispatch(0U, 2U);
+}
+
+void FTM0_Ch4_Ch5_IRQHandler(void)
+{
+    ftm_ch_dispatch(0U, 4U);
+}
+
+void FTM0_Ch6_Ch7_IRQHandler(void)
+{
+    ftm_ch_dispatch(0U, 6U);
+}
+
+void FTM1_Ch0_Ch1_IRQHandler(void)
+{
+    ftm_ch_dispatch(1U, 0U);
+}
+
+void FTM1_Ch2_Ch3_IRQHandler(void)
+{
+    ftm_ch_dispatch(1U, 2U);
+}
+
+void FTM1_Ch4_Ch5_IRQHandler(void)
+{
+    ftm_ch_dispatch(1U, 4U);
+}
+
+void FTM1_Ch6_Ch7_IRQHandler(void)
+{
+    ftm_ch_dispatch(1U, 6U);
+}
+
+void FTM2_Ch0_Ch1_IRQHandler(void)
+{
+    ftm_ch_dispatch(2U, 0U);
+}
+
+void FTM2_Ch2_Ch3_IRQHandler(void)
+{
+    ftm_ch_dispatch(2U, 2U);
+}
+
+void FTM2_Ch4_Ch5_IRQHandler(void)
+{
+    ftm_ch_dispatch(2U, 4U);
+}
+
+void FTM2_Ch6_Ch7_IRQHandler(void)
+{
+    ftm_ch_dispatch(2U, 6U);
+}
+
+void FTM3_Ch0_Ch1_IRQHandler(void)
+{
+    ftm_ch_dispatch(3U, 0U);
+}
+
+void FTM3_Ch2_Ch3_IRQHandler(void)
+{
+    ftm_ch_dispatch(3U, 2U);
+}
+
+void FTM3_Ch4_Ch5_IRQHandler(void)
+{
+    ftm_ch_dispatch(3U, 4U);
+}
+
+void FTM3_Ch6_Ch7_IRQHandler(void)
+{
+    ftm_ch_dispatch(3U, 6U);
+}
+
+void FTM0_Ovf_Reload_IRQHandler(void)
+{
+    ftm_ovf_dispatch(0U);
+}
+
+void FTM1_Ovf_Reload_IRQHandler(void)
+{
+    ftm_ovf_dispatch(1U);
+}
+
+void FTM2_Ovf_Reload_IRQHandler(void)
+{
+    ftm_ovf_dispatch(2U);
+}
+
+void FTM3_Ovf_Reload_IRQHandler(void)
+{
+    ftm_ovf_dispatch(3U);
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Entry of a pin in the mux table
+ * @param: ptx_n: pin
+ * @return: table entry, NULL if the pin has no FTM channel
+ */
+static const ftm_pin_entry *ftm_pin_find(PTXn_e ptx_n)
+{
+    uint8_t i;
+
+    for (i = 0U; i < sizeof(ftm_pin_table) / sizeof(ftm_pin_table[0]); i++) {
+        if (ftm_pin_table[i].pin == ptx_n) {
+            return &ftm_pin_table[i];
+        }
+    }
+    return NULL;
+}
+
+
+/*
+ * @brief: Clear the flags of a channel pair and run their callbacks
+ * @param: ftm: FTM module (0..3)
+ * @param: ch: first channel of the pair
+ */
+static void ftm_ch_dispatch(uint8_t ftm, uint8_t ch)
+{
+    FTM_Type *base = FTMX[ftm];
+    uint32_t csc;
+    uint8_t n;
+
+    for (n = ch; n < ch + 2U; n++) {
+        csc = base->CONTROLS[n].CnSC;
+
+        /* Channels with DMA enabled have their flag cleared by the transfer */
+        if ((csc & (FTM_CnSC_CHF_MASK | FTM_CnSC_CHIE_MASK | FTM_CnSC_DMA_MASK)) ==
+            (FTM_CnSC_CHF_MASK | FTM_CnSC_CHIE_MASK)) {
+            base->CONTROLS[n].CnSC = csc & ~FTM_CnSC_CHF_MASK;
+
+            if (ftm_ch_table[ftm][n].callback != NULL) {
+                ftm_ch_table[ftm][n].callback(ftm, n, ftm_ch_table[ftm][n].ctx);
+            }
+        }
+    }
+}
+
+
+/*
+ * @brief: Count an overflow and run the overflow callback
+ * @param: ftm: FTM module (0..3)
+ */
+static void ftm_ovf_dispatch(uint8_t ftm)
+{
+    FTM_Type *base = FTMX[ftm];
+
+    if (base->SC & FTM_SC_TOF_MASK) {
+        base->SC &= ~FTM_SC_TOF_MASK;
+        ftm_overflow[ftm]++;
+
+        if (capture_dma_slot != NULL && capture_dma_slot->ftm == ftm) {
+            ftm_capture_dma_drain(capture_dma_slot);
+        }
+
+        if (ftm_ovf_table[ftm].callback != NULL) {
+            ftm_ovf_table[ftm].callback(ftm, FTM_OVF_CH, ftm_ovf_table[ftm].ctx);
+        }
+    }
+}
+
+
+/*
+ * @brief: Extend a counter value with the overflow count
+ * @param: ftm: FTM module (0..3)
+ * @param: cnt: CNT or CnV value read before calling
+ * @return: 64-bit tick count
+ * @note: Must run with the overflow interrupt masked (or from a channel ISR)
+ */
+static uint64_t ftm_extend(uint8_t ftm, uint32_t cnt)
+{
+    uint64_t ovf = ftm_overflow[ftm];
+
+    /* Overflow not served yet and the value was latched after it */
+    if ((FTMX[ftm]->SC & FTM_SC_TOF_MASK) && cnt < ftm_period[ftm] / 2U) {
+        ovf++;
+    }
+
+    return ovf * ftm_period[ftm] + cnt;
+}
+
+
+/*
+ * @brief: Count the overflows of a module
+ * @param: ftm: FTM module (0..3)
+ */
+static void ftm_ovf_enable(uint8_t ftm)
+{
+    if (!(FTMX[ftm]->SC & FTM_SC_TOIE_MASK)) {
+        FTMX[ftm]->SC &= ~FTM_SC_TOF_MASK;
+        FTMX[ftm]->SC |= FTM_SC_TOIE_MASK;
+        NVIC_EnableIRQ((IRQn_Type)(FTM0_Ovf_Reload_IRQn + ftm * FTM_IRQ_STRIDE));
+    }
+}
+
+
+/*
+ * @brief: Find the capture slot of a pin
+ * @param: ptx_n: pin given to FTM_CaptureInit()
+ * @return: slot, NULL if the pin is not capturing
+ */
+static ftm_capture_slot *ftm_capture_find(PTXn_e ptx_n)
+{
+    uint8_t i;
+
+    for (i = 0U; i < FTM_CAPTURE_SLOTS; i++) {
+        if (capture_table[i].used && capture_table[i].pin == ptx_n) {
+            return &capture_table[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * @brief: Channel callback of the capture service, push the edge timestamp
+ * @param: ftm: FTM module (0..3)
+ * @param: ch: channel (0..7)
+ * @param: ctx: capture slot
+ */
+static void ftm_capture_isr(uint8_t ftm, uint8_t ch, void *ctx)
+{
+    ftm_capture_slot *slot = (ftm_capture_slot *)ctx;
+    uint8_t head = slot->head;
+    uint8_t next = (head + 1U) & (FTM_CAPTURE_RING - 1U);
+    uint64_t time = ftm_extend(ftm, FTMX[ftm]->CONTROLS[ch].CnV);
+
+    if (next == slot->tail) {
+        slot->lost++;
+        return;
+    }
+
+    slot->ring[head] = time;
+    slot->head = next;
+}
+
+
+/*
+ * @brief: Move the raw values written by the DMA to the timestamp ring
+ * @param: slot: capture slot using DMA_CH_CAPTURE
+ * @note: Every value is extended backwards from the current time, so it must
+ *        be drained less than one counter period after its edge. The overflow
+ *        interrupt drains once per period. Runs with the interrupts masked.
+ */
+static void ftm_capture_dma_drain(ftm_capture_slot *slot)
+{
+    uint32_t period = ftm_period[slot->ftm];
+    uint8_t index = (FTM_CAPTURE_DMA_LEN - DMA_GetCiter(DMA_CH_CAPTURE, false)) & (FTM_CAPTURE_DMA_LEN - 1U);
+    uint64_t now = FTM_GetTime(slot->ftm);      // Read after the index, the drained edges are older
+    uint32_t now_cnt = (uint32_t)(now % period);
+    uint32_t age;
+    uint8_t next;
+
+    while (capture_dma_tail != index) {
+        age = (now_cnt + period - capture_dma_buff[capture_dma_tail]) % period;
+        capture_dma_tail = (capture_dma_tail + 1U) & (FTM_CAPTURE_DMA_LEN - 1U);
+
+        next = (slot->head + 1U) & (FTM_CAPTURE_RING - 1U);
+        if (next == slot->tail) {
+            slot->lost++;
+        }
+        else {
+            slot->ring[slot->head] = now - age;
+            slot->head = next;
+        }
+    }
+}
+
+
+/*
+ * @brief: Select the clock of an FTM for an operating point
+ * @param: ftm: FTM instance (0..3)
+ * @param: profile: SOSCDIV1, or SIRCDIV1 in VLPR where SOSC is stopped
+ * @note: Both give FTM_CLK_HZ. The clock source can only be selected with
+ *        the clock gate disabled, the registers keep their value
+ */
+static void ftm_clock_select(uint8_t ftm, clock_profile profile)
+{
+    PCC->PCCn[ftm_pcc_index[ftm]] = 0U;
+    PCC->PCCn[ftm_pcc_index[ftm]] = PCC_PCCn_PCS((profile == CLOCK_PROFILE_VLPR) ? FTM_PCS_SIRCDIV1 : FTM_PCS_SOSCDIV1)
+                                  | PCC_PCCn_CGC_MASK;
+}
+
+
+/*
+ * @brief: Move the running FTMs to the clock of the new operating point
+ */
+static void ftm_clock_notifier(clock_event event, clock_profile profile, void *ctx)
+{
+    (void)ctx;
+
+    if (event != CLOCK_POST_CHANGE) {
+        return;
+    }
+    for (uint8_t ftm = 0U; ftm < FTM_NUM; ftm++) {
+        if (PCC->PCCn[ftm_pcc_index[ftm]] & PCC_PCCn_CGC_MASK) {
+            ftm_clock_select(ftm, profile);
+        }
+    }
+}
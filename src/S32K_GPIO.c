@@ -44,15 +44,26 @@
 //==============================================================================
 //                                INCLUDES
 //==============================================================================
+#include "include.h"
 #include "S32K_GPIO.h"
 
 //==============================================================================
 //                         LOCAL DEFINES AND MACROS
 //==============================================================================
+#define GPIO_PORT_NUM                  5U
+#define GPIO_PIN_NUM                   32U
+
+/* Count leading zeros, single CLZ instruction on the Cortex-M4 */
+#define GPIO_CLZ(x)                    ((uint8_t)__builtin_clz(x))
 
 //==============================================================================
 //                       LOCAL TYPES AND ENUMERATIONS
 //==============================================================================
+typedef struct {
+    gpio_exti_callback callback;        // Function called for the pin
+    void *ctx;                          // User pointer given to the callback
+    volatile uint32_t count;            // Number of events served
+} gpio_exti_entry;
 
 //==============================================================================
 //                           GLOBAL VARIABLES
@@ -64,10 +75,13 @@ PORT_MemMapPtr PORTX[5] = {PORTA,  PORTB, PORTC, PORTD, PORTE};
 //==============================================================================
 //                          STATIC VARIABLES
 //==============================================================================
+/* Callback table, one entry per pin of every port */
+static gpio_exti_entry exti_table[GPIO_PORT_NUM][GPIO_PIN_NUM];
 
 //==============================================================================
 //                      STATIC FUNCTION DECLARATIONS
 //==============================================================================
+static void gpio_exti_dispatch(uint8_t ptx);
 
 //==============================================================================
 //                       PUBLIC FUNCTION DEFINITIONS
@@ -205,3 +219,181 @@ void GPIO_ExtiInit(PTXn_e ptx_n, exti_cfg cfg)
     /* Set the port to input */
     GPIOX[ptx]->PDDR &= ~(uint32_t)(1 << ptn);
 }
+
+
+void GPIO_ExtiAttach(PTXn_e ptx_n, exti_cfg cfg, gpio_exti_callback callback, void *ctx)
+{
+    uint8_t ptx,ptn;
+
+    ptx = PTX(ptx_n);
+    ptn = PTn(ptx_n);
+
+    /* Register the callback before the pin is able to raise the interrupt */
+    exti_table[ptx][ptn].callback = callback;
+    exti_table[ptx][ptn].ctx = ctx;
+    exti_table[ptx][ptn].count = 0U;
+
+    GPIO_ExtiInit(ptx_n, cfg);
+}
+
+
+void GPIO_ExtiDetach(PTXn_e ptx_n)
+{
+    uint8_t ptx,ptn;
+
+    ptx = PTX(ptx_n);
+    ptn = PTn(ptx_n);
+
+    /* Disable the interrupt and clear a possible pending flag */
+    PORTX[ptx]->PCR[ptn] &= ~PORT_PCR_IRQC_MASK;
+    PORTX[ptx]->ISFR = (uint32_t)(1 << ptn);
+
+    exti_table[ptx][ptn].callback = NULL;
+    exti_table[ptx][ptn].ctx = NULL;
+}
+
+
+uint32_t GPIO_ExtiGetCount(PTXn_e ptx_n)
+{
+    return exti_table[PTX(ptx_n)][PTn(ptx_n)].count;
+}
+
+
+void GPIO_ExtiMask(PTXn_e ptx_n)
+{
+    uint8_t ptx,ptn;
+
+    ptx = PTX(ptx_n);
+    ptn = PTn(ptx_n);
+
+    PORTX[ptx]->PCR[ptn] &= ~PORT_PCR_IRQC_MASK;
+    PORTX[ptx]->ISFR = (uint32_t)(1 << ptn);
+}
+
+
+void GPIO_ExtiUnmask(PTXn_e ptx_n, exti_cfg cfg)
+{
+    uint8_t ptx,ptn;
+
+    ptx = PTX(ptx_n);
+    ptn = PTn(ptx_n);
+
+    PORTX[ptx]->ISFR = (uint32_t)(1 << ptn);
+    PORTX[ptx]->PCR[ptn] = (PORTX[ptx]->PCR[ptn] & ~PORT_PCR_IRQC_MASK) | PORT_PCR_IRQC(cfg & 0x7f);
+}
+
+
+void GPIO_DigitalFilterInit(PTXn_e ptx_n, GPIO_DF_CLK clk, uint8_t width)
+{
+    uint8_t ptx,ptn;
+    uint32_t dfer;
+
+    ptx = PTX(ptx_n);
+    ptn = PTn(ptx_n);
+
+    if (width > GPIO_DF_WIDTH_MAX) {
+        width = GPIO_DF_WIDTH_MAX;
+    }
+
+    /* Enable port clock */
+    PCC->PCCn[PCC_PORTA_INDEX + ptx] = PCC_PCCn_CGC_MASK;
+
+    /* Clock and width can only be changed with every filter of the port disabled */
+    dfer = PORTX[ptx]->DFER;
+    PORTX[ptx]->DFER = 0U;
+    PORTX[ptx]->DFCR = PORT_DFCR_CS(clk);
+    PORTX[ptx]->DFWR = PORT_DFWR_FILT(width);
+    PORTX[ptx]->DFER = dfer | (uint32_t)(1 << ptn);
+}
+
+
+void GPIO_DigitalFilterDisable(PTXn_e ptx_n)
+{
+    PORTX[PTX(ptx_n)]->DFER &= ~(uint32_t)(1 << PTn(ptx_n));
+}
+
+
+bool GPIO_DigitalFilterUs(uint32_t us, GPIO_DF_CLK *clk, uint8_t *width)
+{
+    uint32_t cycles;
+
+    /* Bus clock first, it gives the best resolution */
+    cycles = us * (clock_get_hz(CLOCK_BUS) / 1000000U);
+    if ((cycles > 0U) && (cycles <= GPIO_DF_WIDTH_MAX)) {
+        *clk = GPIO_DF_BUS;
+        *width = (uint8_t)cycles;
+        return true;
+    }
+
+    /* LPO clock, round up so that the filter is never shorter than requested */
+    cycles = ((us * (GPIO_DF_LPO_HZ / 1000U)) + 999U) / 1000U;
+    *clk = GPIO_DF_LPO;
+    if (cycles == 0U) {
+        cycles = 1U;
+    }
+    if (cycles > GPIO_DF_WIDTH_MAX) {
+        *width = GPIO_DF_WIDTH_MAX;
+        return false;
+    }
+    *width = (uint8_t)cycles;
+    return true;
+}
+
+
+void PORTA_IRQHandler(void)
+{
+    gpio_exti_dispatch(0U);
+}
+
+
+void PORTB_IRQHandler(void)
+{
+    gpio_exti_dispatch(1U);
+}
+
+
+void PORTC_IRQHandler(void)
+{
+    gpio_exti_dispatch(2U);
+}
+
+
+void PORTD_IRQHandler(void)
+{
+    gpio_exti_dispatch(3U);
+}
+
+
+void PORTE_IRQHandler(void)
+{
+    gpio_exti_dispatch(4U);
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Serve every pending pin of a port
+ * @param: ptx: port index (0: PORTA ... 4: PORTE)
+ * @note: Only the flags read here are cleared, so an edge arriving while the
+ *        callbacks run keeps its flag and raises the interrupt again.
+ */
+static void gpio_exti_dispatch(uint8_t ptx)
+{
+    uint32_t flags = PORTX[ptx]->ISFR;
+    gpio_exti_entry *entry;
+    uint8_t ptn;
+
+    PORTX[ptx]->ISFR = flags;
+
+    while (flags) {
+        ptn = 31U - GPIO_CLZ(flags);
+        flags &= ~(uint32_t)(1UL << ptn);
+
+        entry = &exti_table[ptx][ptn];
+        entry->count++;
+        if (entry->callback != NULL) {
+            entry->callback((PTXn_e)((ptx << 5) + ptn), entry->ctx);
+        }
+    }
+}
@@ -0,0 +1,332 @@
+/*
+ * =============================================================================
+ * File Name    : S32K_LPIT.c
+ * Project      : S32K144_basic
+ * Module       : LPIT Timer Driver
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   Driver for the 4-channel Low Power Interrupt Timer (LPIT0) on the NXP
+ *   S32K144. Channel 0 runs free as a 32-bit time base, the remaining channels
+ *   are periodic timers with an interrupt callback or a DMA trigger.
+ *
+ *   Channel allocation in this project:
+ *     - LPIT_CH_TIMESTAMP : 0 (free running time base)
+ *     - LPIT_CH_TICK      : 1 (1 ms software tick shared by several callbacks)
+ *     - LPIT_CH_BAM       : 2 (bit angle modulation slots)
+ *     - LPIT_CH_LOGIC     : 3 (logic analyzer sample trigger, DMA channel 3)
+ *
+ * Dependencies :
+ *   - SOSC configured with SOSCDIV2 = 1 (via S32K_PLL.h)
+ *
+ * Configuration :
+ *   - LPIT_CLK_HZ: functional clock of the timer
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "S32K_LPIT.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define LPIT_PCS_SOSCDIV2              1U
+#define LPIT_PCS_SIRCDIV2              2U      // Same 8 MHz, used in VLPR
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+typedef struct {
+    lpit_callback callback;             // Function called on timeout
+    void *ctx;                          // User pointer given to the callback
+} lpit_channel_entry;
+
+typedef struct {
+    lpit_callback callback;             // Function called every period ticks
+    void *ctx;                          // User pointer given to the callback
+    uint16_t period;
+    uint16_t count;
+} lpit_tick_entry;
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+static lpit_channel_entry lpit_table[LPIT_CH_NUM];
+static bool lpit_ready = false;
+static lpit_tick_entry tick_table[LPIT_TICK_SLOTS];
+static bool tick_running = false;
+static volatile uint32_t timestamp_wraps;
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static void lpit_irq_dispatch(uint8_t ch);
+static void lpit_tick_isr(void *ctx);
+static void lpit_clock_select(clock_profile profile);
+static void lpit_clock_notifier(clock_event event, clock_profile profile, void *ctx);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+void LPIT_Init(void)
+{
+    if (lpit_ready) {
+        return;
+    }
+
+    lpit_clock_select(CLOCK_GetProfile());
+    CLOCK_NotifierAttach(lpit_clock_notifier, NULL);
+
+    /* Enable the module, keep running in debug mode */
+    LPIT0->MCR = LPIT_MCR_M_CEN_MASK | LPIT_MCR_DBG_EN_MASK;
+
+    /* Free running 32-bit down counter used as time base, its wraps are counted */
+    LPIT0->TMR[LPIT_CH_TIMESTAMP].TVAL = 0xFFFFFFFFU;
+    LPIT0->MSR = (1UL << LPIT_CH_TIMESTAMP);
+    LPIT0->MIER |= (1UL << LPIT_CH_TIMESTAMP);
+    NVIC_EnableIRQ((IRQn_Type)(LPIT0_Ch0_IRQn + LPIT_CH_TIMESTAMP));
+    LPIT0->TMR[LPIT_CH_TIMESTAMP].TCTRL = LPIT_TMR_TCTRL_MODE(0) | LPIT_TMR_TCTRL_T_EN_MASK;
+
+    lpit_ready = true;
+}
+
+
+void LPIT_ChannelInit(uint8_t ch, uint32_t ticks, lpit_callback callback, void *ctx)
+{
+    LPIT_Init();
+
+    LPIT0->TMR[ch].TCTRL = 0U;
+    LPIT0->TMR[ch].TVAL = ticks - 1U;
+    LPIT0->MSR = (1UL << ch);
+
+    lpit_table[ch].callback = callback;
+    lpit_table[ch].ctx = ctx;
+
+    if (callback != NULL) {
+        LPIT0->MIER |= (1UL << ch);
+        NVIC_EnableIRQ((IRQn_Type)(LPIT0_Ch0_IRQn + ch));
+    }
+    else {
+        LPIT0->MIER &= ~(1UL << ch);
+    }
+}
+
+
+void LPIT_ChannelStart(uint8_t ch)
+{
+    LPIT0->TMR[ch].TCTRL |= LPIT_TMR_TCTRL_T_EN_MASK;
+}
+
+
+void LPIT_ChannelStop(uint8_t ch)
+{
+    LPIT0->TMR[ch].TCTRL &= ~LPIT_TMR_TCTRL_T_EN_MASK;
+    LPIT0->MSR = (1UL << ch);
+}
+
+
+void LPIT_SetPeriod(uint8_t ch, uint32_t ticks)
+{
+    LPIT0->TMR[ch].TVAL = ticks - 1U;
+}
+
+
+uint32_t LPIT_GetTimestamp(void)
+{
+    /* Down counter, invert to get elapsed ticks */
+    return ~LPIT0->TMR[LPIT_CH_TIMESTAMP].CVAL;
+}
+
+
+uint64_t LPIT_GetTimestamp64(void)
+{
+    uint32_t primask;
+    uint32_t high;
+    uint32_t low;
+
+    LPIT_Init();
+
+    DisableInterruptsSave(primask);
+    high = timestamp_wraps;
+    low = LPIT_GetTimestamp();
+    /* Wrapped but not counted yet, the flag is still set */
+    if ((LPIT0->MSR & (1UL << LPIT_CH_TIMESTAMP)) && low < 0x80000000U) {
+        high++;
+    }
+    RestoreInterrupts(primask);
+
+    return ((uint64_t)high << 32) | low;
+}
+
+
+bool LPIT_TickAttach(lpit_callback callback, void *ctx, uint16_t period)
+{
+    uint32_t primask;
+    bool attached = false;
+    uint8_t i;
+
+    LPIT_Init();
+
+    DisableInterruptsSave(primask);
+    for (i = 0U; i < LPIT_TICK_SLOTS; i++) {
+        if (tick_table[i].callback == NULL) {
+            tick_table[i].ctx = ctx;
+            tick_table[i].period = (period > 0U) ? period : 1U;
+            tick_table[i].count = 0U;
+            tick_table[i].callback = callback;
+            attached = true;
+            break;
+        }
+    }
+
+    if (attached && !tick_running) {
+        LPIT_ChannelInit(LPIT_CH_TICK, LPIT_US_TO_TICKS(LPIT_TICK_US), lpit_tick_isr, NULL);
+        LPIT_ChannelStart(LPIT_CH_TICK);
+        tick_running = true;
+    }
+    RestoreInterrupts(primask);
+
+    return attached;
+}
+
+
+void LPIT_TickDetach(lpit_callback callback, void *ctx)
+{
+    uint32_t primask;
+    bool used = false;
+    uint8_t i;
+
+    DisableInterruptsSave(primask);
+    for (i = 0U; i < LPIT_TICK_SLOTS; i++) {
+        if (tick_table[i].callback == callback && tick_table[i].ctx == ctx) {
+            tick_table[i].callback = NULL;
+        }
+        used |= (tick_table[i].callback != NULL);
+    }
+
+    /* No interrupt at all while nobody needs the tick */
+    if (!used && tick_running) {
+        LPIT_ChannelStop(LPIT_CH_TICK);
+        tick_running = false;
+    }
+    RestoreInterrupts(primask);
+}
+
+
+uint32_t LPIT_GetTicks(void)
+{
+    return (uint32_t)(LPIT_GetTimestamp64() / LPIT_US_TO_TICKS(LPIT_TICK_US));
+}
+
+
+void LPIT0_Ch0_IRQHandler(void)
+{
+    uint32_t primask;
+
+    /* Time base wrap: count it and clear the flag as one step for LPIT_GetTimestamp64() */
+    DisableInterruptsSave(primask);
+    timestamp_wraps++;
+    LPIT0->MSR = (1UL << LPIT_CH_TIMESTAMP);
+    RestoreInterrupts(primask);
+}
+
+
+void LPIT0_Ch1_IRQHandler(void)
+{
+    lpit_irq_dispatch(1U);
+}
+
+
+void LPIT0_Ch2_IRQHandler(void)
+{
+    lpit_irq_dispatch(2U);
+}
+
+
+void LPIT0_Ch3_IRQHandler(void)
+{
+    lpit_irq_dispatch(3U);
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Clear the channel flag and run its callback
+ * @param: ch: LPIT channel (0..3)
+ */
+static void lpit_irq_dispatch(uint8_t ch)
+{
+    LPIT0->MSR = (1UL << ch);
+
+    if (lpit_table[ch].callback != NULL) {
+        lpit_table[ch].callback(lpit_table[ch].ctx);
+    }
+}
+
+
+/*
+ * @brief: Software tick, run the callbacks whose period expired
+ * @param: ctx: not used
+ */
+static void lpit_tick_isr(void *ctx)
+{
+    uint8_t i;
+
+    (void)ctx;
+
+    for (i = 0U; i < LPIT_TICK_SLOTS; i++) {
+        if (tick_table[i].callback != NULL && ++tick_table[i].count >= tick_table[i].period) {
+            tick_table[i].count = 0U;
+            tick_table[i].callback(tick_table[i].ctx);
+        }
+    }
+}
+
+
+/*
+ * @brief: Select the LPIT clock for an operating point
+ * @param: profile: SOSCDIV2, or SIRCDIV2 in VLPR where SOSC is stopped
+ * @note: Both give LPIT_CLK_HZ. The clock source can only be selected with
+ *        the clock gate disabled, the timers keep their value
+ */
+static void lpit_clock_select(clock_profile profile)
+{
+    PCC->PCCn[PCC_LPIT_INDEX] = 0U;
+    PCC->PCCn[PCC_LPIT_INDEX] = PCC_PCCn_PCS((profile == CLOCK_PROFILE_VLPR) ? LPIT_PCS_SIRCDIV2 : LPIT_PCS_SOSCDIV2)
+                              | PCC_PCCn_CGC_MASK;
+}
+
+
+/*
+ * @brief: Move the LPIT to the clock of the new operating point
+ */
+static void lpit_clock_notifier(clock_event event, clock_profile profile, void *ctx)
+{
+    (void)ctx;
+
+    if (event == CLOCK_POST_CHANGE) {
+        lpit_clock_select(profile);
+    }
+}
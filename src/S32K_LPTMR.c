@@ -0,0 +1,125 @@
+/*
+ * =============================================================================
+ * File Name    : S32K_LPTMR.c
+ * Project      : S32K144_basic
+ * Module       : LPTMR Timer Driver
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   One-shot millisecond timer on LPTMR0, time counter mode clocked by
+ *   LPO1K_CLK with the prescaler bypassed.
+ *
+ * Dependencies :
+ *   - None
+ *
+ * Configuration :
+ *   - None
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "S32K_LPTMR.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define LPTMR_PCS_LPO1K                1U
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+static lptmr_callback lptmr_cb = NULL;
+static void *lptmr_ctx = NULL;
+static bool lptmr_ready = false;
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+void LPTMR_Init(void)
+{
+    if (lptmr_ready) {
+        return;
+    }
+
+    PCC->PCCn[PCC_LPTMR0_INDEX] = PCC_PCCn_CGC_MASK;
+
+    /* Time counter mode, 1 kHz LPO without prescaler */
+    LPTMR0->CSR = 0U;
+    LPTMR0->PSR = LPTMR_PSR_PCS(LPTMR_PCS_LPO1K) | LPTMR_PSR_PBYP_MASK;
+
+    NVIC_EnableIRQ(LPTMR0_IRQn);
+    lptmr_ready = true;
+}
+
+
+void LPTMR_OneShot(uint16_t ms, lptmr_callback callback, void *ctx)
+{
+    LPTMR_Init();
+
+    /* CMR can only be changed with the timer disabled */
+    LPTMR0->CSR = LPTMR_CSR_TCF_MASK;
+
+    lptmr_cb = callback;
+    lptmr_ctx = ctx;
+
+    /* The flag is set when the counter matches CMR, one count after reset */
+    LPTMR0->CMR = (ms > 1U) ? (ms - 1U) : 0U;
+    LPTMR0->CSR = LPTMR_CSR_TIE_MASK | LPTMR_CSR_TEN_MASK;
+}
+
+
+void LPTMR_Stop(void)
+{
+    LPTMR0->CSR = LPTMR_CSR_TCF_MASK;
+}
+
+
+bool LPTMR_IsRunning(void)
+{
+    return (LPTMR0->CSR & LPTMR_CSR_TEN_MASK) != 0U;
+}
+
+
+void LPTMR0_IRQHandler(void)
+{
+    /* Disable the timer (one-shot) and clear the flag */
+    LPTMR0->CSR = LPTMR_CSR_TCF_MASK;
+
+    if (lptmr_cb != NULL) {
+        lptmr_cb(lptmr_ctx);
+    }
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
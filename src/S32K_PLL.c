@@ -2,30 +2,25 @@
  * =============================================================================
  * File Name    : S32K_PLL.c
  * Project      : S32K144_basic
- * Module       : Clock & PLL Initialization Module (Header)
+ * Module       : Clock & PLL Initialization Module
  * Author       : JuaBue
  * Created On   : 2025-03-13
  * Version      : 1.0.0
  *
  * Description  :
- *   This header file provides functions and configuration options to initialize
- *   the system clocks on the NXP S32K144 microcontroller. It supports setting up
- *   the System PLL (SPLL), external oscillator (XOSC), and RUN mode transitions.
+ *   SPLL_CLK = SOSC / (PREDIV + 1) * (MULT + 16) / 2, with the reference
+ *   (SOSC / (PREDIV + 1)) in 8..16 MHz and the VCO in 180..320 MHz. The core
+ *   clock is SPLL_CLK / DIVCORE, and bus and slow are divided from the core.
  *
- *   Clock configuration options are defined in the `clk_option` enumeration, with
- *   recommended and unstable values annotated.
- *
- *   Example values:
- *     - PLL160: Recommended stable configuration
- *     - PLL220: Unstable
- *     - PLL252: Very unstable (not recommended)
+ *   CLOCK_Solve() tries every PREDIV, MULT and DIVCORE (4096 cases, no float)
+ *   and keeps the closest core clock, then the fastest bus and slow clocks
+ *   under their targets and the limits of the power mode.
  *
  * Dependencies :
  *   - Device-specific SCG, SPLL, and SOSC register definitions
  *
  * Configuration :
- *   - XOSC expected to operate at 8 MHz
- *   - Default RUN mode transitions to 80 MHz using PLL
+ *   - See S32K_PLL.h
  *
  * License :
  *   This file is part of a free software project released under the terms of
@@ -50,149 +45,377 @@
 //==============================================================================
 //                         LOCAL DEFINES AND MACROS
 //==============================================================================
+#define CLOCK_SCS_SOSC                 1U
+#define CLOCK_SCS_SIRC                 2U
+#define CLOCK_SCS_FIRC                 3U
+#define CLOCK_SCS_SPLL                 6U
+
+#define CLOCK_SIRC_HZ                  8000000U
+#define CLOCK_FIRC_HZ                  48000000U
+
+/* SPLL limits */
+#define CLOCK_REF_MIN                  8000000U
+#define CLOCK_REF_MAX                  16000000U
+#define CLOCK_VCO_MIN                  180000000U
+#define CLOCK_VCO_MAX                  320000000U
+
+/* Asynchronous peripheral clocks */
+#define CLOCK_SPLLDIV1_MAX             80000000U
+#define CLOCK_SPLLDIV2_MAX             40000000U
+
+#define CLOCK_PMSTAT_RUN               0x01U
+#define CLOCK_PMSTAT_VLPR              0x04U
+#define CLOCK_PMSTAT_HSRUN             0x80U
 
 //==============================================================================
 //                       LOCAL TYPES AND ENUMERATIONS
 //==============================================================================
+typedef struct {
+    uint32_t core;
+    uint32_t bus;
+    uint32_t slow;
+} clock_limits;
+
+typedef struct {
+    clock_notifier callback;            // Function called around a change
+    void *ctx;                          // User pointer given to the callback
+} clock_notifier_entry;
 
 //==============================================================================
 //                           GLOBAL VARIABLES
 //==============================================================================
-/* Core clock and Bus clock */
-uint32_t core_clk_M;
-uint32_t bus_clk_M;
 
 //==============================================================================
 //                          STATIC VARIABLES
 //==============================================================================
+/* Highest clocks with the SPLL as source, RUN and HSRUN */
+static const clock_limits clock_limit[2] = {
+    { 80000000U, 40000000U, 26666667U },
+    { 112000000U, 56000000U, 28000000U },
+};
+
+/* SPLL configurations of CLOCK_PROFILE_HSRUN and CLOCK_PROFILE_RUN, solved once */
+static clock_config clock_profile_cfg[2];
+static clock_notifier_entry clock_notifier_table[CLOCK_NOTIFIER_SLOTS];
 
 //==============================================================================
 //                      STATIC FUNCTION DECLARATIONS
 //==============================================================================
+static uint8_t clock_divider(uint32_t clk, uint32_t max_hz, uint8_t max_div);
+static uint8_t clock_async_div(uint32_t clk, uint32_t max_hz);
+static uint32_t clock_async_hz(uint32_t clk, uint32_t field);
+static void clock_sosc_enable(uint32_t sosc_hz);
+static void clock_sirc_enable(void);
+static void clock_hsrun_exit(void);
+static void clock_vlpr_enter(void);
+static void clock_vlpr_exit(void);
+static void clock_notify(clock_event event, clock_profile profile);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+bool CLOCK_Solve(uint32_t sosc_hz, uint32_t core_hz, uint32_t bus_hz, uint32_t slow_hz, clock_config *cfg)
+{
+    uint32_t ref, spll, core, bus, slow;
+    uint32_t best_core = 0U, best_bus = 0U, best_slow = 0U;
+    uint8_t divbus, divslow;
+    clock_mode mode;
+    bool found = false;
+
+    for (uint8_t prediv = 0U; prediv < 8U; prediv++) {
+        ref = sosc_hz / (prediv + 1U);
+        if (ref < CLOCK_REF_MIN || ref > CLOCK_REF_MAX) {
+            continue;
+        }
+
+        for (uint8_t mult = 0U; mult < 32U; mult++) {
+            if (ref * (mult + 16U) < CLOCK_VCO_MIN || ref * (mult + 16U) > CLOCK_VCO_MAX) {
+                continue;
+            }
+            spll = ref * (mult + 16U) / 2U;
+
+            for (uint8_t divcore = 1U; divcore <= 16U; divcore++) {
+                core = spll / divcore;
+                if (core > core_hz || core > clock_limit[CLOCK_MODE_HSRUN].core) {
+                    continue;
+                }
+
+                /* RUN if everything fits, else HSRUN */
+                mode = (core <= clock_limit[CLOCK_MODE_RUN].core) ? CLOCK_MODE_RUN : CLOCK_MODE_HSRUN;
+                divbus = clock_divider(core, (bus_hz < clock_limit[mode].bus) ? bus_hz : clock_limit[mode].bus, 16U);
+                divslow = clock_divider(core, (slow_hz < clock_limit[mode].slow) ? slow_hz : clock_limit[mode].slow, 8U);
+                if (divbus == 0U || divslow == 0U) {
+                    continue;
+                }
+                bus = core / divbus;
+                slow = core / divslow;
+
+                /* Closest core first, then the fastest bus and slow clocks */
+                if (found && (core < best_core ||
+                             (core == best_core && (bus < best_bus ||
+                                                   (bus == best_bus && slow <= best_slow))))) {
+                    continue;
+                }
+
+                found = true;
+                best_core = core;
+                best_bus = bus;
+                best_slow = slow;
+                cfg->sosc_hz = sosc_hz;
+                cfg->mode = mode;
+                cfg->prediv = prediv;
+                cfg->mult = mult;
+                cfg->divcore = divcore - 1U;
+                cfg->divbus = divbus - 1U;
+                cfg->divslow = divslow - 1U;
+                cfg->spll_hz = spll;
+                cfg->core_hz = core;
+                cfg->bus_hz = bus;
+                cfg->slow_hz = slow;
+                cfg->splldiv1 = clock_async_div(spll, CLOCK_SPLLDIV1_MAX);
+                cfg->splldiv2 = clock_async_div(spll, CLOCK_SPLLDIV2_MAX);
+            }
+        }
+    }
+
+    return found;
+}
+
+
+void CLOCK_Apply(const clock_config *cfg)
+{
+    const uint32_t firc = SCG_RCCR_SCS(CLOCK_SCS_FIRC)       // 48 MHz core, 24 MHz bus and flash
+                        | SCG_RCCR_DIVCORE(0U)
+                        | SCG_RCCR_DIVBUS(1U)
+                        | SCG_RCCR_DIVSLOW(1U);
+
+    /* Written once after reset, every mode is allowed */
+    SMC->PMPROT = SMC_PMPROT_AHSRUN_MASK | SMC_PMPROT_AVLP_MASK;
+
+    /* Leave HSRUN and the SPLL: run from FIRC in RUN */
+    clock_hsrun_exit();
+    SCG->RCCR = firc;
+    while (((SCG->CSR & SCG_CSR_SCS_MASK) >> SCG_CSR_SCS_SHIFT) != CLOCK_SCS_FIRC);
+
+    clock_sosc_enable(cfg->sosc_hz);
+
+    /* The SPLL can only be changed while it is disabled */
+    while (SCG->SPLLCSR & SCG_SPLLCSR_LK_MASK);
+    SCG->SPLLCSR = 0U;
+    SCG->SPLLDIV = SCG_SPLLDIV_SPLLDIV1(cfg->splldiv1)
+                 | SCG_SPLLDIV_SPLLDIV2(cfg->splldiv2);
+    SCG->SPLLCFG = SCG_SPLLCFG_PREDIV(cfg->prediv)
+                 | SCG_SPLLCFG_MULT(cfg->mult);
+    SCG->SPLLCSR = SCG_SPLLCSR_SPLLEN_MASK;
+    while (!(SCG->SPLLCSR & SCG_SPLLCSR_SPLLVLD_MASK));
+
+    if (cfg->mode == CLOCK_MODE_HSRUN) {
+        SCG->HCCR = SCG_HCCR_SCS(CLOCK_SCS_SPLL)
+                  | SCG_HCCR_DIVCORE(cfg->divcore)
+                  | SCG_HCCR_DIVBUS(cfg->divbus)
+                  | SCG_HCCR_DIVSLOW(cfg->divslow);
+        SMC->PMCTRL = SMC_PMCTRL_RUNM(3U);
+        while (SMC->PMSTAT != CLOCK_PMSTAT_HSRUN);
+    }
+    else {
+        SCG->RCCR = SCG_RCCR_SCS(CLOCK_SCS_SPLL)
+                  | SCG_RCCR_DIVCORE(cfg->divcore)
+                  | SCG_RCCR_DIVBUS(cfg->divbus)
+                  | SCG_RCCR_DIVSLOW(cfg->divslow);
+    }
+    while (((SCG->CSR & SCG_CSR_SCS_MASK) >> SCG_CSR_SCS_SHIFT) != CLOCK_SCS_SPLL);
+}
+
+
+bool CLOCK_Init(uint32_t core_hz, uint32_t bus_hz, uint32_t slow_hz)
+{
+    clock_config cfg;
+
+    if (!CLOCK_Solve(CLOCK_SOSC_HZ, core_hz, bus_hz, slow_hz, &cfg)) {
+        return false;
+    }
+    CLOCK_Apply(&cfg);
+
+    return true;
+}
+
+
+uint32_t clock_get_hz(clock_name clk)
+{
+    uint32_t csr = SCG->CSR;
+    uint32_t src;
+    uint32_t cfg;
+
+    switch (clk) {
+    case CLOCK_CORE:
+    case CLOCK_BUS:
+    case CLOCK_SLOW:
+        switch ((csr & SCG_CSR_SCS_MASK) >> SCG_CSR_SCS_SHIFT) {
+        case CLOCK_SCS_SOSC:
+            src = clock_get_hz(CLOCK_SOSC);
+            break;
+        case CLOCK_SCS_SIRC:
+            src = clock_get_hz(CLOCK_SIRC);
+            break;
+        case CLOCK_SCS_FIRC:
+            src = CLOCK_FIRC_HZ;
+            break;
+        case CLOCK_SCS_SPLL:
+            src = clock_get_hz(CLOCK_SPLL);
+            break;
+        default:
+            return 0U;
+        }
+        src /= ((csr & SCG_CSR_DIVCORE_MASK) >> SCG_CSR_DIVCORE_SHIFT) + 1U;
+        if (clk == CLOCK_BUS) {
+            src /= ((csr & SCG_CSR_DIVBUS_MASK) >> SCG_CSR_DIVBUS_SHIFT) + 1U;
+        }
+        else if (clk == CLOCK_SLOW) {
+            src /= ((csr & SCG_CSR_DIVSLOW_MASK) >> SCG_CSR_DIVSLOW_SHIFT) + 1U;
+        }
+        return src;
+
+    case CLOCK_SOSC:
+        return (SCG->SOSCCSR & SCG_SOSCCSR_SOSCVLD_MASK) ? CLOCK_SOSC_HZ : 0U;
+
+    case CLOCK_SOSCDIV1:
+        return clock_async_hz(clock_get_hz(CLOCK_SOSC), (SCG->SOSCDIV & SCG_SOSCDIV_SOSCDIV1_MASK) >> SCG_SOSCDIV_SOSCDIV1_SHIFT);
+
+    case CLOCK_SOSCDIV2:
+        return clock_async_hz(clock_get_hz(CLOCK_SOSC), (SCG->SOSCDIV & SCG_SOSCDIV_SOSCDIV2_MASK) >> SCG_SOSCDIV_SOSCDIV2_SHIFT);
+
+    case CLOCK_SIRC:
+        if (!(SCG->SIRCCSR & SCG_SIRCCSR_SIRCVLD_MASK)) {
+            return 0U;
+        }
+        return (SCG->SIRCCFG & SCG_SIRCCFG_RANGE_MASK) ? CLOCK_SIRC_HZ : (CLOCK_SIRC_HZ / 4U);
+
+    case CLOCK_SIRCDIV1:
+        return clock_async_hz(clock_get_hz(CLOCK_SIRC), (SCG->SIRCDIV & SCG_SIRCDIV_SIRCDIV1_MASK) >> SCG_SIRCDIV_SIRCDIV1_SHIFT);
+
+    case CLOCK_SIRCDIV2:
+        return clock_async_hz(clock_get_hz(CLOCK_SIRC), (SCG->SIRCDIV & SCG_SIRCDIV_SIRCDIV2_MASK) >> SCG_SIRCDIV_SIRCDIV2_SHIFT);
+
+    case CLOCK_FIRC:
+        return (SCG->FIRCCSR & SCG_FIRCCSR_FIRCVLD_MASK) ? CLOCK_FIRC_HZ : 0U;
+
+    case CLOCK_SPLL:
+        if (!(SCG->SPLLCSR & SCG_SPLLCSR_SPLLVLD_MASK)) {
+            return 0U;
+        }
+        cfg = SCG->SPLLCFG;
+        return clock_get_hz(CLOCK_SOSC) / (((cfg & SCG_SPLLCFG_PREDIV_MASK) >> SCG_SPLLCFG_PREDIV_SHIFT) + 1U)
+             * (((cfg & SCG_SPLLCFG_MULT_MASK) >> SCG_SPLLCFG_MULT_SHIFT) + 16U) / 2U;
+
+    case CLOCK_SPLLDIV1:
+        return clock_async_hz(clock_get_hz(CLOCK_SPLL), (SCG->SPLLDIV & SCG_SPLLDIV_SPLLDIV1_MASK) >> SCG_SPLLDIV_SPLLDIV1_SHIFT);
+
+    case CLOCK_SPLLDIV2:
+        return clock_async_hz(clock_get_hz(CLOCK_SPLL), (SCG->SPLLDIV & SCG_SPLLDIV_SPLLDIV2_MASK) >> SCG_SPLLDIV_SPLLDIV2_SHIFT);
+
+    default:
+        return 0U;
+    }
+}
+
+
+clock_profile CLOCK_GetProfile(void)
+{
+    switch (SMC->PMSTAT) {
+    case CLOCK_PMSTAT_HSRUN:
+        return CLOCK_PROFILE_HSRUN;
+    case CLOCK_PMSTAT_VLPR:
+        return CLOCK_PROFILE_VLPR;
+    default:
+        return CLOCK_PROFILE_RUN;
+    }
+}
+
+
+bool CLOCK_SetProfile(clock_profile profile)
+{
+    uint32_t primask;
+    const clock_limits *limit;
+    clock_profile from = CLOCK_GetProfile();
+
+    if (profile == from) {
+        return true;
+    }
+
+    /* Solved before the interrupts are disabled, the search takes a while at 4 MHz */
+    if (profile != CLOCK_PROFILE_VLPR && clock_profile_cfg[profile].core_hz == 0U) {
+        limit = &clock_limit[(profile == CLOCK_PROFILE_HSRUN) ? CLOCK_MODE_HSRUN : CLOCK_MODE_RUN];
+        if (!CLOCK_Solve(CLOCK_SOSC_HZ, limit->core, limit->bus, limit->slow, &clock_profile_cfg[profile])) {
+            return false;
+        }
+    }
+
+    DisableInterruptsSave(primask);
+    clock_notify(CLOCK_PRE_CHANGE, profile);
+
+    if (from == CLOCK_PROFILE_VLPR) {
+        clock_vlpr_exit();
+    }
+    if (profile == CLOCK_PROFILE_VLPR) {
+        clock_vlpr_enter();
+    }
+    else {
+        CLOCK_Apply(&clock_profile_cfg[profile]);
+    }
+
+    clock_notify(CLOCK_POST_CHANGE, profile);
+    RestoreInterrupts(primask);
+
+    return true;
+}
+
+
+bool CLOCK_NotifierAttach(clock_notifier callback, void *ctx)
+{
+    uint32_t primask;
+    clock_notifier_entry *slot = NULL;
+    uint8_t i;
+
+    for (i = 0U; i < CLOCK_NOTIFIER_SLOTS; i++) {
+        if (clock_notifier_table[i].callback == callback && clock_notifier_table[i].ctx == ctx) {
+            return true;
+        }
+        if (slot == NULL && clock_notifier_table[i].callback == NULL) {
+            slot = &clock_notifier_table[i];
+        }
+    }
+    if (slot == NULL) {
+        return false;
+    }
+
+    DisableInterruptsSave(primask);
+    slot->ctx = ctx;
+    slot->callback = callback;
+    RestoreInterrupts(primask);
+
+    return true;
+}
+
+
+void CLOCK_NotifierDetach(clock_notifier callback, void *ctx)
+{
+    uint32_t primask;
+    uint8_t i;
+
+    DisableInterruptsSave(primask);
+    for (i = 0U; i < CLOCK_NOTIFIER_SLOTS; i++) {
+        if (clock_notifier_table[i].callback == callback && clock_notifier_table[i].ctx == ctx) {
+            clock_notifier_table[i].callback = NULL;
+            clock_notifier_table[i].ctx = NULL;
+        }
+    }
+    RestoreInterrupts(primask);
+}
+
 
 void MCU_Init(void)
 {
-	//OSC_OUT = 8MHz, 8MHz EXTAL
-    SCG->SOSCDIV = SCG_SOSCDIV_SOSCDIV1(1)      // System OSC DIV1=1
-                 | SCG_SOSCDIV_SOSCDIV2(1);     // System OSC DIV2=1
-    SCG->SOSCCFG = SCG_SOSCCFG_RANGE(2) 		// Medium frequency range OSC 1-8MHz
-	             | SCG_SOSCCFG_EREFS(1);	    // Select internal OSC
-    while(SCG->SOSCCSR & SCG_SOSCCSR_LK_MASK);  // Wait for SOSCCSR unlocked state
-    SCG->SOSCCSR = SCG_SOSCCSR_SOSCEN_MASK;     // Enable OSC
-    while(!(SCG->SOSCCSR & SCG_SOSCCSR_SOSCVLD_MASK));    // Wait for OSC enabling and valid output
-    // SPLL Configuration
-    // PLL_OUT = 112MHz, 8MHz EXTAL
-    SCG->SPLLDIV = SCG_SPLLDIV_SPLLDIV1(1)    // PLL DIV1=1
-                 | SCG_SPLLDIV_SPLLDIV2(1);   // PLL DIV2=1
-    SCG->SPLLCFG = SCG_SPLLCFG_PREDIV(0)      // PLL PREDIV=0
-                 | SCG_SPLLCFG_MULT(12);      // PLL MULT=28
-    while(SCG->SPLLCSR & SCG_SPLLCSR_LK_MASK);// Wait for SPLLCSR unlocked state
-    SCG->SPLLCSR=SCG_SPLLCSR_SPLLEN_MASK;     // Enable PLL
-    while(!(SCG->SPLLCSR & SCG_SPLLCSR_SPLLVLD_MASK)); // Wait for PLL enabling and valid output
-    // HCCR Configuration
-    // PLL_OUT = 112MHz, 8MHz EXTAL
-    SCG->HCCR = SCG_HCCR_SCS(6)               // PLL source clock
-              | SCG_HCCR_DIVCORE(0)           // DIVCORE=1, Core=112MHz
-              | SCG_HCCR_DIVBUS(1)            // DIVBUS=2, BUS=56MHz
-              | SCG_HCCR_DIVSLOW(3);          // DIVSLOW=4, Flash=28MHz
-    SMC->PMPROT=SMC_PMPROT_AHSRUN_MASK        // Allows High Speed Run
-              | SMC_PMPROT_AVLP_MASK;         // Allows Very Low Power Modes
-    SMC->PMCTRL=SMC_PMCTRL_RUNM(3);           // Entry to High Speed Run
-    // Wait for High Speed Run mode
-    while(SMC->PMSTAT != SMC_PMSTAT_PMSTAT(128)){}
-}
-
-
-void SPLL_Init(clk_option opt)
-{
-    uint8_t pll_prdiv;
-    uint8_t pll_mult;
-
-    if(opt!= PLLUNULL) {
-      //clock configure PLL
-      switch(opt) {
-      case PLL100:
-        pll_prdiv   = 0U;
-        pll_mult    = 9U;
-        break;
-      case PLL112:
-        pll_prdiv   = 0U;
-        pll_mult    = 12U;      //4*28=112
-        break;
-      case PLL160:
-        pll_prdiv   = 0U;
-        pll_mult    = 24U;      //PLL =  8M * (pll_mult+16)/2/(prdiv+1)=160
-        break;
-      case PLL180:
-        pll_prdiv   = 0U;       //45*4=180
-        pll_mult    = 29U;
-        break;
-      case PLL184:
-        pll_prdiv   = 0U;       //46*4=184
-        pll_mult    = 30U;
-        break;
-      case PLL188:
-        pll_prdiv   = 0U;       //4*47=188
-        pll_mult    = 31U;
-        break;
-
-      /***********************************************/
-      case PLL200:
-        pll_prdiv   = 0U;       //50*4=200
-        pll_mult    = 34U;
-        break;
-      case PLL220:
-        pll_prdiv   = 0U;       //55*4=220
-        pll_mult    = 39U;
-        break;
-      case PLL252:
-        pll_prdiv   = 0U;       //63*4=252
-        pll_mult    = 47U;
-        break;
-      /***********************************************/
-
-      default:
-        pll_prdiv   = 0U;
-        pll_mult    = 24U;
-        break;                  //(unknown value, default initialize 180M)
-      }
-    }
-
-    core_clk_M = (8 * ((pll_mult + 16)/2/(pll_prdiv + 1)));
-    bus_clk_M =core_clk_M/2;
-    //  WDOG_Disable();
-    //OSC_OUT = 8MHz, 8MHz EXTAL
-    SCG->SOSCDIV = SCG_SOSCDIV_SOSCDIV1(1)                // System OSC DIV1=1
-                  |SCG_SOSCDIV_SOSCDIV2(1);               // System OSC DIV2=1
-    SCG->SOSCCFG = SCG_SOSCCFG_RANGE(3)                   // Range=3: high freq (SOSC betw 8MHz-32MHz)
-                  |SCG_SOSCCFG_EREFS(1);                  // EREFS=1: Input is external XTAL
-    while(SCG->SOSCCSR & SCG_SOSCCSR_LK_MASK);            // Wait for SOSCCSR unlocked state
-    SCG->SOSCCSR=SCG_SOSCCSR_SOSCEN_MASK;                 // Enable OSC
-    while(!(SCG->SOSCCSR & SCG_SOSCCSR_SOSCVLD_MASK));    // Wait for OSC enabling and valid output
-    // SPLL Configuration
-    // PLL_OUT = 112MHz, 8MHz EXTAL
-    SCG->SPLLDIV = SCG_SPLLDIV_SPLLDIV1(1)                // PLL DIV1=1
-                 | SCG_SPLLDIV_SPLLDIV2(1);               // PLL DIV2=1
-
-    /* PREDIV=0: Divide SOSC_CLK by 0+1=1 */
-    /* MULT=24:  Multiply sys pll by 24+16=40 */
-    /* SPLL_CLK = 8MHz / 1 * 40 / 2 = 160 MHz */
-    SCG->SPLLCFG = SCG_SPLLCFG_PREDIV(pll_prdiv)          // PLL PREDIV=0
-                 | SCG_SPLLCFG_MULT(pll_mult);            // PLL MULT=24
-
-    while(SCG->SPLLCSR & SCG_SPLLCSR_LK_MASK);            // Wait for SPLLCSR unlocked state
-    SCG->SPLLCSR=SCG_SPLLCSR_SPLLEN_MASK;                 // Enable PLL
-    while(!(SCG->SPLLCSR & SCG_SPLLCSR_SPLLVLD_MASK));    // Wait for PLL enabling and valid output
-    // HCCR Configuration
-    // PLL_OUT = 160MHz, 8MHz EXTAL
-    SCG->HCCR = SCG_HCCR_SCS(6)                           // PLL source clock
-              | SCG_HCCR_DIVCORE(1)                       // DIVCORE=1, Core
-              | SCG_HCCR_DIVBUS(1)                        // DIVBUS=1,  BUS
-              | SCG_HCCR_DIVSLOW(2);                      // DIVSLOW=3, Flash
-    SMC->PMPROT=SMC_PMPROT_AHSRUN_MASK                    // Allows High Speed Run
-              | SMC_PMPROT_AVLP_MASK;                     // Allows Very Low Power Modes
-    SMC->PMCTRL=SMC_PMCTRL_RUNM(3);                       // Entry to High Speed Run
-    // Wait for High Speed Run mode
+    CLOCK_Init(112000000U, 56000000U, 28000000U);
 }
 
 
@@ -205,50 +428,195 @@ void SCG_Init(void)
     PCC->PCCn[PCC_PORTD_INDEX] = PCC_PCCn_CGC_MASK;
     PCC->PCCn[PCC_PORTE_INDEX] = PCC_PCCn_CGC_MASK;
 
-    // *** System OSC ***
-    SCG->SOSCDIV=0x00000101;    /* SOSCDIV1 & SOSCDIV2 =1: divide by 1 */
-    SCG->SOSCCFG=0x00000034;    /* Range=3: high freq (SOSC betw 8MHz-32MHz)*/
-                                /* HGO=0:   Config xtal osc for low power */
-                                /* EREFS=1: Input is external XTAL */
-    while(SCG->SOSCCSR & SCG_SOSCCSR_LK_MASK); /* Ensure SOSCCSR unlocked */
-    SCG->SOSCCSR=0x00000001;  /* LK=0:          SOSCCSR can be written */
-                                /* SOSCCMRE=0:    OSC CLK monitor IRQ if enabled */
-                                /* SOSCCM=0:      OSC CLK monitor disabled */
-                                /* SOSCERCLKEN=0: Sys OSC 3V ERCLK output clk disabled */
-                                /* SOSCLPEN=0:    Sys OSC disabled in VLP modes */
-                                /* SOSCSTEN=0:    Sys OSC disabled in Stop modes */
-                                /* SOSCEN=1:      Enable oscillator */
-    while(!(SCG->SOSCCSR & SCG_SOSCCSR_SOSCVLD_MASK)); /* Wait for sys OSC clk valid */
-
-    // *** System PLL ***
-    SCG->SPLLDIV = 0x00000101;  /* SOSCPLL1 & SPLLDIV2 =1: divide by 1 */
-    SCG->SPLLCFG = 0x00180000;  /* PREDIV=0: Divide SOSC_CLK by 0+1=1 */
-                                /* MULT=24:  Multiply sys pll by 24+16=40 */
-                                /* SPLL_CLK = 8MHz / 1 * 40 / 2 = 160 MHz */
-    while(SCG->SPLLCSR & SCG_SPLLCSR_LK_MASK); /* Ensure SPLLCSR unlocked */
-    SCG->SPLLCSR = 0x00000001; /* LK=0:        SPLLCSR can be written */
-                                /* SPLLCMRE=0:  SPLL CLK monitor IRQ if enabled */
-                                /* SPLLCM=0:    SPLL CLK monitor disabled */
-                                /* SPLLSTEN=0:  SPLL disabled in Stop modes */
-                                /* SPLLEN=1:    Enable SPLL */
-    while(!(SCG->SPLLCSR & SCG_SPLLCSR_SPLLVLD_MASK)); /* Wait for SPLL valid */
-
-    // *** MODE CONFIG ***
-    SCG->RCCR=SCG_RCCR_SCS(6)  /* PLL as clock source*/
-        |SCG_RCCR_DIVCORE(1)   /* DIVCORE= 2, Core/Sys clock = 80 MHz*/
-        |SCG_RCCR_DIVBUS(3)    /* DIVBUS = 4, bus clock = 40 MHz*/
-        |SCG_RCCR_DIVSLOW(7);  /* DIVSLOW = 8, SCG slow, flash clock= 20 MHz*/
-
-    SMC->PMCTRL  = SMC_PMCTRL_RUNM(0);    //enter RUN
+    CLOCK_Init(80000000U, 40000000U, 20000000U);
 }
 
 
 void NormalRUNmode_80MHz(void)
 {
-    SCG->RCCR = SCG_RCCR_SCS(6)     /* PLL as clock source */
-        | SCG_RCCR_DIVCORE(0x01)    /* DIVCORE=1, div. by 2: Core clock = 160/2 MHz = 80 MHz */
-        | SCG_RCCR_DIVBUS(0x01)     /* DIVBUS=1, div. by 2: bus clock = 40MHz */
-        | SCG_RCCR_DIVSLOW(0x02);   /* DIVSLOW=2, div. by 2: SCG slow, flash clock= 26 2/3 MHz */
-    /* Wait for sys clk src = SPLL */
-    while (((SCG->CSR & SCG_CSR_SCS_MASK) >> SCG_CSR_SCS_SHIFT) != 6);
+    CLOCK_Init(CLOCK_CORE_HZ, CLOCK_BUS_HZ, CLOCK_SLOW_HZ);
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Smallest divider that brings a clock under a limit
+ * @param: clk: clock to divide
+ * @param: max_hz: highest result
+ * @param: max_div: highest divider
+ * @return: divider (1..max_div), 0 if none fits
+ */
+static uint8_t clock_divider(uint32_t clk, uint32_t max_hz, uint8_t max_div)
+{
+    for (uint8_t div = 1U; div <= max_div; div++) {
+        if (clk / div <= max_hz) {
+            return div;
+        }
+    }
+    return 0U;
+}
+
+
+/*
+ * @brief: SOSCDIV / SPLLDIV field that brings a clock under a limit
+ * @param: clk: clock to divide
+ * @param: max_hz: highest result
+ * @return: field value, 1: /1 .. 7: /64
+ */
+static uint8_t clock_async_div(uint32_t clk, uint32_t max_hz)
+{
+    uint8_t field = 1U;
+
+    while (field < 7U && (clk >> (field - 1U)) > max_hz) {
+        field++;
+    }
+    return field;
+}
+
+
+/*
+ * @brief: Output of an asynchronous divider
+ * @param: clk: input clock
+ * @param: field: SOSCDIV / SIRCDIV / SPLLDIV field, 0 is disabled
+ * @return: frequency in Hz
+ */
+static uint32_t clock_async_hz(uint32_t clk, uint32_t field)
+{
+    return (field == 0U) ? 0U : (clk >> (field - 1U));
+}
+
+
+/*
+ * @brief: Start the crystal oscillator, SOSCDIV1 and SOSCDIV2 divide by 1
+ * @param: sosc_hz: crystal frequency
+ * @note: Nothing is done if it already runs, it may be feeding the SPLL
+ */
+static void clock_sosc_enable(uint32_t sosc_hz)
+{
+    if (SCG->SOSCCSR & SCG_SOSCCSR_SOSCVLD_MASK) {
+        return;
+    }
+
+    SCG->SOSCDIV = SCG_SOSCDIV_SOSCDIV1(1U)
+                 | SCG_SOSCDIV_SOSCDIV2(1U);
+    SCG->SOSCCFG = SCG_SOSCCFG_RANGE((sosc_hz >= 8000000U) ? 3U : 2U)  // High range from 8 MHz
+                 | SCG_SOSCCFG_EREFS(1U);                              // External crystal
+    while (SCG->SOSCCSR & SCG_SOSCCSR_LK_MASK);
+    SCG->SOSCCSR = SCG_SOSCCSR_SOSCEN_MASK;
+    while (!(SCG->SOSCCSR & SCG_SOSCCSR_SOSCVLD_MASK));
+}
+
+
+/*
+ * @brief: Start SIRC at 8 MHz with SIRCDIV1 and SIRCDIV2 dividing by 1
+ * @note: SIRCLPEN keeps it running in VLPR. Must not be the system clock
+ *        when the dividers change
+ */
+static void clock_sirc_enable(void)
+{
+    const uint32_t div = SCG_SIRCDIV_SIRCDIV1(1U)
+                       | SCG_SIRCDIV_SIRCDIV2(1U);
+    const uint32_t on = SCG_SIRCCSR_SIRCVLD_MASK | SCG_SIRCCSR_SIRCLPEN_MASK;
+
+    if ((SCG->SIRCCSR & on) == on && (SCG->SIRCCFG & SCG_SIRCCFG_RANGE_MASK) &&
+        (SCG->SIRCDIV & (SCG_SIRCDIV_SIRCDIV1_MASK | SCG_SIRCDIV_SIRCDIV2_MASK)) == div) {
+        return;
+    }
+
+    while (SCG->SIRCCSR & SCG_SIRCCSR_LK_MASK);
+    SCG->SIRCCSR = 0U;
+    SCG->SIRCDIV = div;
+    SCG->SIRCCFG = SCG_SIRCCFG_RANGE(1U);                      // 8 MHz
+    SCG->SIRCCSR = SCG_SIRCCSR_SIRCEN_MASK
+                 | SCG_SIRCCSR_SIRCLPEN_MASK;
+    while (!(SCG->SIRCCSR & SCG_SIRCCSR_SIRCVLD_MASK));
+}
+
+
+/*
+ * @brief: Go from HSRUN to RUN, the core runs from FIRC
+ * @note: Nothing is done in RUN
+ */
+static void clock_hsrun_exit(void)
+{
+    if (SMC->PMSTAT != CLOCK_PMSTAT_HSRUN) {
+        return;
+    }
+
+    SCG->HCCR = SCG_HCCR_SCS(CLOCK_SCS_FIRC)
+              | SCG_HCCR_DIVCORE(0U)
+              | SCG_HCCR_DIVBUS(1U)
+              | SCG_HCCR_DIVSLOW(1U);
+    while (((SCG->CSR & SCG_CSR_SCS_MASK) >> SCG_CSR_SCS_SHIFT) != CLOCK_SCS_FIRC);
+    SMC->PMCTRL = SMC_PMCTRL_RUNM(0U);
+    while (SMC->PMSTAT != CLOCK_PMSTAT_RUN);
+}
+
+
+/*
+ * @brief: Enter VLPR from RUN or HSRUN
+ * @note: VLPR only allows SIRC: the core moves to it in RUN, then SPLL, FIRC
+ *        and SOSC are stopped before the mode change
+ */
+static void clock_vlpr_enter(void)
+{
+    const uint32_t sirc = SCG_VCCR_SCS(CLOCK_SCS_SIRC)         // 4 MHz core and bus, 1 MHz flash
+                        | SCG_VCCR_DIVCORE(1U)
+                        | SCG_VCCR_DIVBUS(0U)
+                        | SCG_VCCR_DIVSLOW(3U);
+
+    SMC->PMPROT = SMC_PMPROT_AHSRUN_MASK | SMC_PMPROT_AVLP_MASK;
+
+    clock_hsrun_exit();
+    clock_sirc_enable();
+
+    /* Same layout in VCCR and RCCR */
+    SCG->VCCR = sirc;
+    SCG->RCCR = sirc;
+    while (((SCG->CSR & SCG_CSR_SCS_MASK) >> SCG_CSR_SCS_SHIFT) != CLOCK_SCS_SIRC);
+
+    while (SCG->SPLLCSR & SCG_SPLLCSR_LK_MASK);
+    SCG->SPLLCSR = 0U;
+    while (SCG->FIRCCSR & SCG_FIRCCSR_LK_MASK);
+    SCG->FIRCCSR = 0U;
+    while (SCG->SOSCCSR & SCG_SOSCCSR_LK_MASK);
+    SCG->SOSCCSR = 0U;
+
+    /* Biasing is needed by the low power regulator */
+    PMC->REGSC |= PMC_REGSC_BIASEN_MASK;
+    SMC->PMCTRL = SMC_PMCTRL_RUNM(2U);
+    while (SMC->PMSTAT != CLOCK_PMSTAT_VLPR);
+}
+
+
+/*
+ * @brief: Go from VLPR to RUN, the core still runs from SIRC
+ * @note: FIRC is started again, CLOCK_Apply() switches through it
+ */
+static void clock_vlpr_exit(void)
+{
+    SMC->PMCTRL = SMC_PMCTRL_RUNM(0U);
+    while (SMC->PMSTAT != CLOCK_PMSTAT_RUN);
+
+    SCG->FIRCCSR = SCG_FIRCCSR_FIRCEN_MASK;
+    while (!(SCG->FIRCCSR & SCG_FIRCCSR_FIRCVLD_MASK));
+}
+
+
+/*
+ * @brief: Call the registered notifiers
+ * @param: event: CLOCK_PRE_CHANGE (last registered first) or CLOCK_POST_CHANGE
+ * @param: profile: operating point being entered
+ */
+static void clock_notify(clock_event event, clock_profile profile)
+{
+    clock_notifier_entry *entry;
+
+    for (uint8_t i = 0U; i < CLOCK_NOTIFIER_SLOTS; i++) {
+        entry = &clock_notifier_table[(event == CLOCK_PRE_CHANGE) ? (CLOCK_NOTIFIER_SLOTS - 1U - i) : i];
+        if (entry->callback != NULL) {
+            entry->callback(event, profile, entry->ctx);
+        }
+    }
 }
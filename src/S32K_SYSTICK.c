@@ -64,6 +64,7 @@ struct time {
 //==============================================================================
 static inline uint32_t systime_get_current_time_ms(void);
 static inline uint64_t systime_get_current_time_us(void);
+static void systime_clock_notifier(clock_event event, clock_profile profile, void *ctx);
 
 //==============================================================================
 //                       PUBLIC FUNCTION DEFINITIONS
@@ -73,8 +74,9 @@ void systime_init(void)
     uint32_t ticks;
     const uint32_t priority = 0xFU;
 
-    timer.fac_us = bus_clk_M;
-    timer.fac_ms = bus_clk_M * 1000;
+    /* SysTick runs from the core clock */
+    timer.fac_us = clock_get_hz(CLOCK_CORE) / 1000000U;
+    timer.fac_ms = timer.fac_us * 1000;
     timer.ms_per_tick = EACH_PER_MS;
     timer.millisecond = 100;
     ticks = timer.fac_ms * timer.ms_per_tick;
@@ -92,6 +94,9 @@ void systime_init(void)
                            S32_SysTick_CSR_TICKINT_MASK |
                            S32_SysTick_CSR_ENABLE_MASK;
     }
+
+    /* Follow the core clock of CLOCK_SetProfile() */
+    CLOCK_NotifierAttach(systime_clock_notifier, NULL);
 }
 
 void systime_delay_us(uint32_t us)
@@ -137,4 +142,34 @@ static inline uint64_t systime_get_current_time_us(void)
 }
 
 
+/*
+ * @brief: Recompute the factors and the reload for a new core clock
+ * @note: The time read before the change is kept, the next interrupt comes
+ *        one full period after the change
+ */
+static void systime_clock_notifier(clock_event event, clock_profile profile, void *ctx)
+{
+    static uint32_t now;
+    uint32_t ticks;
+
+    (void)profile;
+    (void)ctx;
+
+    if (event == CLOCK_PRE_CHANGE) {
+        now = systime_get_current_time_ms();
+        if (S32_SCB->ICSR & S32_SCB_ICSR_PENDSTSET_MASK) {
+            now += timer.ms_per_tick;
+        }
+        return;
+    }
 
+    timer.fac_us = clock_get_hz(CLOCK_CORE) / 1000000U;
+    timer.fac_ms = timer.fac_us * 1000;
+    ticks = timer.fac_ms * timer.ms_per_tick;
+    if (ticks <= S32_SysTick_RVR_RELOAD_MASK) {
+        S32_SysTick->RVR = ticks - 1;
+    }
+    S32_SysTick->CVR = 0U;
+    S32_SCB->ICSR = S32_SCB_ICSR_PENDSTCLR_MASK;
+    timer.millisecond = now + timer.ms_per_tick;
+}
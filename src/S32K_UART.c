@@ -51,6 +51,12 @@
 //==============================================================================
 //                         LOCAL DEFINES AND MACROS
 //==============================================================================
+#define UART_PCS_SIRCDIV2              2U      // Functional clock in VLPR
+#define UART_PCS_SPLLDIV2              6U
+#define UART_OSR_MIN                   4U      // Oversampling ratio, BOTHEDGE below 8
+#define UART_OSR_MAX                   32U
+#define UART_SBR_MAX                   0x1FFFU
+
 //Set the macro _DLIB_FILE_DESCRIPTOR (Options -> Compiler C/C++ -> Preprocessor)
 
 //==============================================================================
@@ -74,10 +80,21 @@ FILE __stdout;
 //==============================================================================
 //                          STATIC VARIABLES
 //==============================================================================
+static LPUART_Type *const uart_base[UART_NUM] = { LPUART0, LPUART1, LPUART2 };
+static uart_rx_callback uart_rx_table[UART_NUM];
+static void *uart_rx_ctx[UART_NUM];
+static const uint8_t uart_pcc_index[UART_NUM] = {
+    PCC_LPUART0_INDEX, PCC_LPUART1_INDEX, PCC_LPUART2_INDEX
+};
+static uint32_t uart_baud[UART_NUM];                    // 0 until UART_Init()
 
 //==============================================================================
 //                      STATIC FUNCTION DECLARATIONS
 //==============================================================================
+static void uart_rx_dispatch(uint8_t n);
+static void uart_clock_select(uint8_t n, clock_profile profile);
+static void uart_set_baud(uint8_t n);
+static void uart_clock_notifier(clock_event event, clock_profile profile, void *ctx);
 
 //==============================================================================
 //                       PUBLIC FUNCTION DEFINITIONS
@@ -203,8 +220,7 @@ void UART_PinInit(LPUART_Type *base)
 
 void UART_Init(LPUART_Type *base, uint32 baud)
 {
-    /* Use SPLL crystal clock sbr = baud_clock / ((OSR+1)  OSR_id) */
-    uint16_t sbr = core_clk_M * 1000000UL / baud / 15;
+    uint8_t n;
 
     /* Enable GPIO clock. For convenience, turn on all */
     PCC->PCCn[PCC_PORTA_INDEX] = PCC_PCCn_CGC_MASK;
@@ -216,13 +232,17 @@ void UART_Init(LPUART_Type *base, uint32 baud)
     /* Pin initialization */
     UART_PinInit(base);
 
-    /* SBR is 13 bits, the maximum is 0x1FFF; */
-    if(sbr > 0x1FFF) {
-        sbr = 0x1FFF;
+    for (n = 0U; n < UART_NUM && uart_base[n] != base; n++);
+    if (n == UART_NUM) {
+        return;
     }
 
-    /* Set baud rate and open serial port */
-    base->BAUD = 0x0E000000|sbr;
+    /* Set baud rate and open serial port, the baud follows CLOCK_SetProfile() */
+    uart_clock_select(n, CLOCK_GetProfile());
+    uart_baud[n] = baud;
+    base->CTRL = 0U;
+    uart_set_baud(n);
+    CLOCK_NotifierAttach(uart_clock_notifier, NULL);
     base->CTRL = LPUART_CTRL_RE_MASK    // Enable reception
                 |LPUART_CTRL_TE_MASK    // Enable Transmition
                 |LPUART_CTRL_RIE_MASK;  // Enable receive interrupt
@@ -260,3 +280,140 @@ uint8_t UART_GetChar(LPUART_Type *base)
     return base->DATA;
 }
 
+void UART_RxAttach(LPUART_Type *base, uart_rx_callback callback, void *ctx)
+{
+    const IRQn_Type irq[UART_NUM] = LPUART_RX_TX_IRQS;
+    uint8_t n;
+
+    for (n = 0U; n < UART_NUM; n++) {
+        if (uart_base[n] == base) {
+            NVIC_DisableIRQ(irq[n]);
+            uart_rx_table[n] = callback;
+            uart_rx_ctx[n] = ctx;
+
+            /* RIE is set by UART_Init(), only the NVIC line is switched */
+            if (callback != NULL) {
+                NVIC_EnableIRQ(irq[n]);
+            }
+            break;
+        }
+    }
+}
+
+void LPUART0_RxTx_IRQHandler(void)
+{
+    uart_rx_dispatch(0U);
+}
+
+void LPUART1_RxTx_IRQHandler(void)
+{
+    uart_rx_dispatch(1U);
+}
+
+void LPUART2_RxTx_IRQHandler(void)
+{
+    uart_rx_dispatch(2U);
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Pass the received chars of a UART to its callback
+ * @param: n: UART number (0..2)
+ */
+static void uart_rx_dispatch(uint8_t n)
+{
+    LPUART_Type *base = uart_base[n];
+    uint8_t data;
+
+    /* A lost char must not block the receiver */
+    if (base->STAT & LPUART_STAT_OR_MASK) {
+        base->STAT |= LPUART_STAT_OR_MASK;
+    }
+
+    while (base->STAT & LPUART_STAT_RDRF_MASK) {
+        data = (uint8_t)base->DATA;
+        if (uart_rx_table[n] != NULL) {
+            uart_rx_table[n](data, uart_rx_ctx[n]);
+        }
+    }
+}
+
+
+/*
+ * @brief: Select the functional clock of a UART for an operating point
+ * @param: n: UART number (0..2)
+ * @param: profile: SPLLDIV2, or SIRCDIV2 in VLPR where the SPLL is stopped
+ * @note: PCS can only change while the clock is gated, the registers keep
+ *        their value
+ */
+static void uart_clock_select(uint8_t n, clock_profile profile)
+{
+    PCC->PCCn[uart_pcc_index[n]] = 0U;
+    PCC->PCCn[uart_pcc_index[n]] = PCC_PCCn_PCS((profile == CLOCK_PROFILE_VLPR) ? UART_PCS_SIRCDIV2 : UART_PCS_SPLLDIV2)
+                                 | PCC_PCCn_CGC_MASK;
+}
+
+
+/*
+ * @brief: Program the baud rate of a UART from its functional clock
+ * @param: n: UART number (0..2)
+ * @note: baud = clock / (OSR * SBR), the OSR with the smallest error is used,
+ *        so the 8 MHz clock of VLPR still gives 115200 within 1 %
+ */
+static void uart_set_baud(uint8_t n)
+{
+    LPUART_Type *base = uart_base[n];
+    uint32_t pcs = (PCC->PCCn[uart_pcc_index[n]] & PCC_PCCn_PCS_MASK) >> PCC_PCCn_PCS_SHIFT;
+    uint32_t clk = clock_get_hz((pcs == UART_PCS_SIRCDIV2) ? CLOCK_SIRCDIV2 : CLOCK_SPLLDIV2);
+    uint32_t baud = uart_baud[n];
+    uint32_t best_osr = 16U, best_sbr = UART_SBR_MAX, best_err = 0xFFFFFFFFU;
+    uint32_t sbr, err, ctrl;
+
+    for (uint32_t osr = UART_OSR_MIN; osr <= UART_OSR_MAX; osr++) {
+        sbr = (clk + osr * baud / 2U) / (osr * baud);
+        if (sbr == 0U || sbr > UART_SBR_MAX) {
+            continue;
+        }
+        err = clk / (osr * sbr);
+        err = (err > baud) ? (err - baud) : (baud - err);
+        /* Ties go to the higher OSR, more samples per bit */
+        if (err <= best_err) {
+            best_err = err;
+            best_osr = osr;
+            best_sbr = sbr;
+        }
+    }
+
+    /* BAUD can only be written with the transmitter and receiver off */
+    ctrl = base->CTRL;
+    base->CTRL = ctrl & ~(LPUART_CTRL_TE_MASK | LPUART_CTRL_RE_MASK);
+    base->BAUD = LPUART_BAUD_OSR(best_osr - 1U)
+               | LPUART_BAUD_SBR(best_sbr)
+               | ((best_osr < 8U) ? LPUART_BAUD_BOTHEDGE_MASK : 0U);
+    base->CTRL = ctrl;
+}
+
+
+/*
+ * @brief: Keep the baud rate of the open UARTs across CLOCK_SetProfile()
+ * @note: The last char is sent before the clocks change
+ */
+static void uart_clock_notifier(clock_event event, clock_profile profile, void *ctx)
+{
+    (void)ctx;
+
+    for (uint8_t n = 0U; n < UART_NUM; n++) {
+        if (uart_baud[n] == 0U) {
+            continue;
+        }
+        if (event == CLOCK_PRE_CHANGE) {
+            while (!(uart_base[n]->STAT & LPUART_STAT_TC_MASK));
+        }
+        else {
+            uart_clock_select(n, profile);
+            uart_set_baud(n);
+        }
+    }
+}
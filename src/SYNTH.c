@@ -0,0 +1,471 @@
+/*
+ * =============================================================================
+ * File Name    : SYNTH.c
+ * Project      : S32K144_basic
+ * Module       : Wavetable Synthesizer
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   The renderer is the PCM source. For every block it first updates the
+ *   envelopes (control rate), then mixes the voices two at a time into a Q30
+ *   accumulator per sample:
+ *
+ *     acc += wave_a * gain_a + wave_b * gain_b        (SMLAD)
+ *     gain_a:gain_b += step_a:step_b                  (QADD16)
+ *
+ *   The gains ramp from the envelope level at the start of the block to the
+ *   level at its end, so the envelope has no steps. Gains are scaled down by
+ *   SYNTH_GAIN_SHIFT, so the accumulator cannot overflow with all the voices
+ *   at full level, and the sum is saturated when it is converted to 8 bits.
+ *
+ * Dependencies :
+ *   - PCM module
+ *
+ * Configuration :
+ *   - See SYNTH.h
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "SYNTH.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define SYNTH_ENV_MAX                  0x7FFFFFFFL     // Envelope level, Q31
+#define SYNTH_OUT_SHIFT                16U             // Q30 mix to Q15, one voice at full level is half scale
+#define SYNTH_BENCH_BLOCKS             16U
+
+/* Dual 16-bit DSP instructions of the Cortex-M4, C for other targets */
+#if defined (__ARM_FEATURE_DSP)
+#define SYNTH_SMLAD(x, y, acc, r)      __asm volatile ("smlad %0, %1, %2, %3" : "=r" (r) : "r" (x), "r" (y), "r" (acc))
+#define SYNTH_QADD16(x, y, r)          __asm volatile ("qadd16 %0, %1, %2" : "=r" (r) : "r" (x), "r" (y))
+#define SYNTH_SSAT16(x, r)             __asm volatile ("ssat %0, #16, %1" : "=r" (r) : "r" (x))
+#else
+#define SYNTH_LO(x)                    ((int32_t)(int16_t)((x) & 0xFFFFU))
+#define SYNTH_HI(x)                    ((int32_t)(int16_t)((x) >> 16))
+#define SYNTH_SAT16(x)                 (((x) > 32767) ? 32767 : (((x) < -32768) ? -32768 : (x)))
+#define SYNTH_SMLAD(x, y, acc, r)      ((r) = (acc) + SYNTH_LO(x) * SYNTH_LO(y) + SYNTH_HI(x) * SYNTH_HI(y))
+#define SYNTH_QADD16(x, y, r)          ((r) = ((uint32_t)(uint16_t)SYNTH_SAT16(SYNTH_LO(x) + SYNTH_LO(y))) | \
+                                              ((uint32_t)(uint16_t)SYNTH_SAT16(SYNTH_HI(x) + SYNTH_HI(y)) << 16))
+#define SYNTH_SSAT16(x, r)             ((r) = SYNTH_SAT16(x))
+#endif
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+typedef enum {
+    SYNTH_IDLE,
+    SYNTH_ATTACK,
+    SYNTH_DECAY,
+    SYNTH_SUSTAIN,
+    SYNTH_RELEASE,
+} synth_stage;
+
+typedef struct {
+    uint32_t phase;
+    uint32_t inc;                       // Phase step per sample
+    int32_t env;                        // Envelope level, Q31
+    int32_t attack;                     // Envelope steps per sample, Q31
+    int32_t decay;
+    int32_t sustain;
+    int32_t release;
+    uint16_t release_ms;
+    volatile synth_stage stage;
+} synth_voice;
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+/* One period of a sine, Q15 */
+const int16_t synth_sine[SYNTH_WAVE_LEN] = {
+         0,    804,   1608,   2410,   3212,   4011,   4808,   5602,
+      6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+     12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+     18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+     23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,
+     27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+     30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,
+     32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+     32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,
+     32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,
+     30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683,
+     27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+     23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,
+     18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279,
+     12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,
+      6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,
+         0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602,
+     -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+    -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+    -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+    -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+    -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+    -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+    -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+    -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+    -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+    -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+    -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+    -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+    -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+    -12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,
+     -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804
+};
+
+/* Envelopes for the demos */
+const synth_adsr synth_piano = { 5U, 400U, 0x2000, 300U };
+const synth_adsr synth_beep = { 2U, 0U, 0x7FFF, 10U };
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+static synth_voice synth_voices[SYNTH_VOICES];
+static const int16_t *synth_wave = synth_sine;
+static int32_t synth_mix[PCM_SAMPLES];
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static int32_t synth_env_step(uint16_t ms, int32_t range);
+static uint32_t synth_env_block(synth_voice *v, uint16_t count);
+static void synth_render(int32_t *mix, uint16_t count);
+static uint16_t synth_source(uint8_t *samples, uint16_t count, void *ctx);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+void SYNTH_Start(const int16_t *wave)
+{
+    SYNTH_Stop();
+
+    synth_wave = (wave != NULL) ? wave : synth_sine;
+    PCM_Stream(SYNTH_RATE_HZ, synth_source, NULL);
+}
+
+
+void SYNTH_Stop(void)
+{
+    PCM_Stop();
+
+    for (uint8_t i = 0; i < SYNTH_VOICES; i++) {
+        synth_voices[i].stage = SYNTH_IDLE;
+    }
+}
+
+
+int8_t SYNTH_NoteOn(uint16_t freq_hz, const synth_adsr *env)
+{
+    uint32_t primask;
+    synth_voice *v;
+    int8_t voice = -1;
+    int32_t lowest = SYNTH_ENV_MAX;
+    int32_t sustain = (int32_t)env->sustain << 16;
+    uint32_t inc = (uint32_t)(((uint64_t)freq_hz << 32) / SYNTH_RATE_HZ);
+    int32_t attack = synth_env_step(env->attack_ms, SYNTH_ENV_MAX);
+    int32_t decay = synth_env_step(env->decay_ms, SYNTH_ENV_MAX - sustain);
+
+    /* An idle voice, or the quietest released one */
+    for (uint8_t i = 0; i < SYNTH_VOICES; i++) {
+        if (synth_voices[i].stage == SYNTH_IDLE) {
+            voice = (int8_t)i;
+            break;
+        }
+        if (synth_voices[i].stage == SYNTH_RELEASE && synth_voices[i].env <= lowest) {
+            lowest = synth_voices[i].env;
+            voice = (int8_t)i;
+        }
+    }
+    if (voice < 0) {
+        return -1;
+    }
+
+    v = &synth_voices[voice];
+
+    /* Steps solved above, the renderer sees the whole voice or none of it */
+    DisableInterruptsSave(primask);
+    v->phase = 0U;
+    v->inc = inc;
+    v->env = 0;
+    v->sustain = sustain;
+    v->attack = attack;
+    v->decay = decay;
+    v->release_ms = env->release_ms;
+    v->stage = SYNTH_ATTACK;
+    RestoreInterrupts(primask);
+
+    return voice;
+}
+
+
+void SYNTH_NoteOff(uint8_t voice)
+{
+    uint32_t primask;
+    synth_voice *v;
+
+    if (voice >= SYNTH_VOICES) {
+        return;
+    }
+    v = &synth_voices[voice];
+
+    DisableInterruptsSave(primask);
+    if (v->stage != SYNTH_IDLE && v->stage != SYNTH_RELEASE) {
+        /* Release from the level reached, in release_ms */
+        v->release = synth_env_step(v->release_ms, v->env);
+        v->stage = SYNTH_RELEASE;
+    }
+    RestoreInterrupts(primask);
+}
+
+
+void SYNTH_AllOff(void)
+{
+    for (uint8_t i = 0; i < SYNTH_VOICES; i++) {
+        SYNTH_NoteOff(i);
+    }
+}
+
+
+uint8_t SYNTH_ActiveVoices(void)
+{
+    uint8_t n = 0U;
+
+    for (uint8_t i = 0; i < SYNTH_VOICES; i++) {
+        if (synth_voices[i].stage != SYNTH_IDLE) {
+            n++;
+        }
+    }
+
+    return n;
+}
+
+
+uint32_t SYNTH_Benchmark(uint8_t voices)
+{
+    uint32_t start, ticks;
+
+    /* Sustained notes, so the envelope work is the same on every block */
+    for (uint8_t i = 0; i < SYNTH_VOICES; i++) {
+        synth_voices[i].stage = SYNTH_IDLE;
+    }
+    for (uint8_t i = 0; i < voices && i < SYNTH_VOICES; i++) {
+        SYNTH_NoteOn((uint16_t)(440U + 110U * i), &synth_beep);
+        synth_voices[i].env = SYNTH_ENV_MAX;
+        synth_voices[i].stage = SYNTH_SUSTAIN;
+    }
+
+    start = LPIT_GetTimestamp();
+    for (uint8_t b = 0; b < SYNTH_BENCH_BLOCKS; b++) {
+        synth_render(synth_mix, PCM_SAMPLES);
+    }
+    ticks = LPIT_GetTimestamp() - start;
+
+    for (uint8_t i = 0; i < SYNTH_VOICES; i++) {
+        synth_voices[i].stage = SYNTH_IDLE;
+    }
+
+    /* LPIT ticks to core cycles */
+    return (ticks * (clock_get_hz(CLOCK_CORE) / 1000000U) / (LPIT_CLK_HZ / 1000000U)) / (SYNTH_BENCH_BLOCKS * PCM_SAMPLES);
+}
+
+
+void Test_SYNTH(void)
+{
+    uint32_t base, cycles;
+    int8_t chord[3];
+
+    PCM_Init();
+
+    /* Cost of the mix, the pairs of idle voices are skipped */
+    base = SYNTH_Benchmark(0U);
+    printf("SYNTH: %lu cycles/sample with no voice\n", (unsigned long)base);
+    for (uint8_t n = 2U; n <= SYNTH_VOICES; n += 2U) {
+        cycles = SYNTH_Benchmark(n);
+        printf("SYNTH: %u voices, %lu cycles/sample, %lu cycles/voice/sample, %lu%% CPU\n",
+               n, (unsigned long)cycles, (unsigned long)((cycles - base) / n),
+               (unsigned long)(cycles * SYNTH_RATE_HZ / (clock_get_hz(CLOCK_CORE) / 100U)));
+    }
+
+    SYNTH_Start(synth_sine);
+
+    /* C major chord */
+    chord[0] = SYNTH_NoteOn(262U, &synth_piano);
+    chord[1] = SYNTH_NoteOn(330U, &synth_piano);
+    chord[2] = SYNTH_NoteOn(392U, &synth_piano);
+    delay(1000);
+    for (uint8_t i = 0; i < 3U; i++) {
+        if (chord[i] >= 0) {
+            SYNTH_NoteOff((uint8_t)chord[i]);
+        }
+    }
+    delay(500);
+
+    /* Two tone alarm, two voices each */
+    for (uint8_t i = 0; i < 8U; i++) {
+        int8_t a = SYNTH_NoteOn((i & 1U) ? 1400U : 1000U, &synth_beep);
+        int8_t b = SYNTH_NoteOn((i & 1U) ? 2800U : 2000U, &synth_beep);
+        delay(150);
+        if (a >= 0) {
+            SYNTH_NoteOff((uint8_t)a);
+        }
+        if (b >= 0) {
+            SYNTH_NoteOff((uint8_t)b);
+        }
+        delay(50);
+    }
+
+    while (SYNTH_ActiveVoices() != 0U);
+    SYNTH_Stop();
+}
+
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Envelope step per sample to cover a range in a time
+ * @param: ms: time of the stage, 0 for one sample
+ * @param: range: Q31 level to cover
+ * @return: Q31 step per sample
+ */
+static int32_t synth_env_step(uint16_t ms, int32_t range)
+{
+    uint32_t samples = (uint32_t)ms * (SYNTH_RATE_HZ / 1000U);
+
+    return (samples == 0U) ? range : (int32_t)((uint32_t)range / samples);
+}
+
+
+/*
+ * @brief: Advance the envelope of a voice by a block
+ * @param: v: voice, not idle
+ * @param: count: samples of the block
+ * @return: packed gains, bits 15..0 gain at the start, bits 31..16 step per
+ *          sample to reach the end level (both scaled by SYNTH_GAIN_SHIFT)
+ */
+static uint32_t synth_env_block(synth_voice *v, uint16_t count)
+{
+    int32_t start = v->env;
+    int64_t env = start;
+
+    switch (v->stage) {
+    case SYNTH_ATTACK:
+        env += (int64_t)v->attack * count;
+        if (env >= SYNTH_ENV_MAX) {
+            env = SYNTH_ENV_MAX;
+            v->stage = SYNTH_DECAY;
+        }
+        break;
+
+    case SYNTH_DECAY:
+        env -= (int64_t)v->decay * count;
+        if (env <= v->sustain) {
+            env = v->sustain;
+            v->stage = SYNTH_SUSTAIN;
+        }
+        break;
+
+    case SYNTH_RELEASE:
+        env -= (int64_t)v->release * count;
+        if (env <= 0) {
+            env = 0;
+            v->stage = SYNTH_IDLE;
+        }
+        break;
+
+    default:
+        break;
+    }
+    v->env = (int32_t)env;
+
+    start >>= (16U + SYNTH_GAIN_SHIFT);
+    env >>= (16U + SYNTH_GAIN_SHIFT);
+
+    return (uint32_t)(uint16_t)start | ((uint32_t)(uint16_t)(int16_t)((env - start) / count) << 16);
+}
+
+
+/*
+ * @brief: Mix all the voices into a block
+ * @param: mix: returns the Q30 sum of every sample (scaled by SYNTH_GAIN_SHIFT)
+ * @param: count: samples of the block
+ */
+static void synth_render(int32_t *mix, uint16_t count)
+{
+    synth_voice *a, *b;
+    uint32_t ga, gb, gain, step, pa, pb, wave;
+    const int16_t *table = synth_wave;
+
+    for (uint16_t i = 0; i < count; i++) {
+        mix[i] = 0;
+    }
+
+    for (uint8_t n = 0; n < SYNTH_VOICES; n += 2U) {
+        a = &synth_voices[n];
+        b = &synth_voices[n + 1U];
+        if (a->stage == SYNTH_IDLE && b->stage == SYNTH_IDLE) {
+            continue;
+        }
+
+        /* Idle voice of the pair: zero gain, the phase does not matter */
+        ga = (a->stage != SYNTH_IDLE) ? synth_env_block(a, count) : 0U;
+        gb = (b->stage != SYNTH_IDLE) ? synth_env_block(b, count) : 0U;
+        gain = (ga & 0xFFFFU) | (gb << 16);
+        step = (ga >> 16) | (gb & 0xFFFF0000U);
+        pa = a->phase;
+        pb = b->phase;
+
+        for (uint16_t i = 0; i < count; i++) {
+            wave = (uint16_t)table[pa >> (32U - SYNTH_WAVE_BITS)]
+                 | ((uint32_t)(uint16_t)table[pb >> (32U - SYNTH_WAVE_BITS)] << 16);
+            SYNTH_SMLAD(wave, gain, mix[i], mix[i]);
+            SYNTH_QADD16(gain, step, gain);
+            pa += a->inc;
+            pb += b->inc;
+        }
+
+        a->phase = pa;
+        b->phase = pb;
+    }
+}
+
+
+/*
+ * @brief: PCM source, renders a block and converts it to 8-bit samples
+ * @param: samples: buffer to fill
+ * @param: count: samples wanted, at most PCM_SAMPLES
+ * @param: ctx: not used
+ * @return: count, the stream never ends
+ */
+static uint16_t synth_source(uint8_t *samples, uint16_t count, void *ctx)
+{
+    int32_t s;
+
+    (void)ctx;
+
+    synth_render(synth_mix, count);
+    for (uint16_t i = 0; i < count; i++) {
+        SYNTH_SSAT16(synth_mix[i] >> (SYNTH_OUT_SHIFT - SYNTH_GAIN_SHIFT), s);
+        samples[i] = (uint8_t)((s >> 8) + 128);
+    }
+
+    return count;
+}
@@ -0,0 +1,367 @@
+/*
+ * =============================================================================
+ * File Name    : WS2812.c
+ * Project      : S32K144_basic
+ * Module       : Addressable LED Strip Module
+ * Author       : JuaBue
+ * Created On   : 2026-10-19
+ * Version      : 1.0.0
+ *
+ * Description  :
+ *   LPSPI1 runs as master in continuous mode with 8-bit frames, so there is no
+ *   gap between bytes and only SOUT is used. The DMA copies one transmit
+ *   buffer to TDR and interrupts at the end, where the next frame (if any) is
+ *   started. Every transmit buffer ends with zero bytes that keep the line low
+ *   for the latch time, SOUT keeps the last (low) bit when the FIFO is empty.
+ *
+ * Dependencies :
+ *   - DMA driver
+ *
+ * Configuration :
+ *   - See WS2812.h
+ *
+ * License :
+ *   This file is part of a free software project released under the terms of
+ *   the GNU General Public License version 3 (GPLv3).
+ *
+ *   You are free to use, modify, and distribute this file under the conditions
+ *   of the GPLv3, as long as you retain this header and provide proper
+ *   attribution to the original author.
+ *
+ *   See <https://www.gnu.org/licenses/gpl-3.0.html> for the full license text.
+ *
+ *   Copyright (c) 2025 Juan I. Bueno
+ *   All rights reserved.
+ *
+ * =============================================================================
+ */
+
+//==============================================================================
+//                                INCLUDES
+//==============================================================================
+#include "WS2812.h"
+
+//==============================================================================
+//                         LOCAL DEFINES AND MACROS
+//==============================================================================
+#define WS2812_PCS_SOSCDIV2            1U
+#define WS2812_PCS_SIRCDIV2            2U
+#define WS2812_CLK_HZ                  CLOCK_SOSC_HZ           // SOSCDIV2_CLK, SIRCDIV2_CLK in VLPR
+#define WS2812_SCK_HZ                  (WS2812_CLK_HZ / 3U)    // SCKDIV = 1
+#define WS2812_BYTES_PER_LED           (WS2812_BPP * 3U)       // 3 SPI bits per bit
+#define WS2812_RESET_BYTES             ((WS2812_RESET_US * (WS2812_SCK_HZ / 1000U) / 8000U) + 1U)
+#define WS2812_BUFF_SIZE               (WS2812_MAX_LEDS * WS2812_BYTES_PER_LED + WS2812_RESET_BYTES)
+#define WS2812_IDLE                    0xFFU
+
+/* SPI code of a data byte, MSB first: 0 -> 100, 1 -> 110 */
+#define WS_BIT(x, n)                   ((((x) >> (n)) & 1U) ? 6UL : 4UL)
+#define WS_EXP(x)                      ((WS_BIT(x, 7) << 21) | (WS_BIT(x, 6) << 18) | \
+                                        (WS_BIT(x, 5) << 15) | (WS_BIT(x, 4) << 12) | \
+                                        (WS_BIT(x, 3) << 9)  | (WS_BIT(x, 2) << 6)  | \
+                                        (WS_BIT(x, 1) << 3)  |  WS_BIT(x, 0))
+#define WS_EXP4(x)                     WS_EXP(x), WS_EXP((x) + 1U), WS_EXP((x) + 2U), WS_EXP((x) + 3U)
+#define WS_EXP16(x)                    WS_EXP4(x), WS_EXP4((x) + 4U), WS_EXP4((x) + 8U), WS_EXP4((x) + 12U)
+#define WS_EXP64(x)                    WS_EXP16(x), WS_EXP16((x) + 16U), WS_EXP16((x) + 32U), WS_EXP16((x) + 48U)
+
+//==============================================================================
+//                       LOCAL TYPES AND ENUMERATIONS
+//==============================================================================
+
+//==============================================================================
+//                           GLOBAL VARIABLES
+//==============================================================================
+
+//==============================================================================
+//                          STATIC VARIABLES
+//==============================================================================
+/* 24-bit SPI code of every byte value */
+static const uint32_t ws2812_exp[256] = {
+    WS_EXP64(0U), WS_EXP64(64U), WS_EXP64(128U), WS_EXP64(192U)
+};
+
+static uint8_t ws2812_pixels[WS2812_MAX_LEDS][WS2812_BPP];     // Wire order G, R, B, W
+static uint8_t ws2812_buff[2][WS2812_BUFF_SIZE];                // Latch bytes stay zero
+static uint16_t ws2812_count = 0U;
+static volatile uint8_t ws2812_active = WS2812_IDLE;            // Buffer being sent
+static volatile bool ws2812_pending = false;                    // Other buffer waits
+static volatile uint32_t ws2812_frames = 0U;
+
+//==============================================================================
+//                      STATIC FUNCTION DECLARATIONS
+//==============================================================================
+static void ws2812_start(uint8_t buff);
+static void ws2812_dma_callback(uint8_t ch, void *ctx);
+static void ws2812_clock_select(clock_profile profile);
+static void ws2812_clock_notifier(clock_event event, clock_profile profile, void *ctx);
+static uint32_t ws2812_wheel(uint8_t pos);
+
+//==============================================================================
+//                       PUBLIC FUNCTION DEFINITIONS
+//==============================================================================
+void WS2812_Init(uint16_t count)
+{
+    ws2812_count = (count > WS2812_MAX_LEDS) ? WS2812_MAX_LEDS : count;
+
+    /* Data output only, SCK and PCS are not routed */
+    PCC->PCCn[PCC_PORTB_INDEX] = PCC_PCCn_CGC_MASK;
+    PORTB->PCR[PTn(WS2812_PIN)] = PORT_PCR_MUX(3);
+
+    /* LPSPI1 from SOSCDIV2, or SIRCDIV2 in VLPR */
+    ws2812_clock_select(CLOCK_GetProfile());
+    CLOCK_NotifierAttach(ws2812_clock_notifier, NULL);
+
+    LPSPI1->CR = LPSPI_CR_RST_MASK;
+    LPSPI1->CR = 0U;
+    LPSPI1->CFGR1 = LPSPI_CFGR1_MASTER_MASK;                    // SOUT keeps the last bit
+    LPSPI1->CCR = LPSPI_CCR_SCKDIV(1U);                         // 8 MHz / (1 + 2)
+    LPSPI1->FCR = LPSPI_FCR_TXWATER(2U);
+    LPSPI1->DER = LPSPI_DER_TDDE_MASK;
+    LPSPI1->CR = LPSPI_CR_MEN_MASK | LPSPI_CR_DBGEN_MASK;
+
+    /* 8-bit frames, back to back, receive data discarded */
+    LPSPI1->TCR = LPSPI_TCR_FRAMESZ(7U) | LPSPI_TCR_CONT_MASK | LPSPI_TCR_RXMSK_MASK;
+
+    DMA_Init();
+    DMA_ChannelMux(DMA_CH_WS2812, EDMA_REQ_LPSPI1_TX, false);
+    DMA_ChannelAttach(DMA_CH_WS2812, ws2812_dma_callback, NULL);
+
+    WS2812_Fill(0U);
+    WS2812_Show();
+}
+
+
+void WS2812_SetPixel(uint16_t led, uint32_t color)
+{
+    if (led >= ws2812_count) {
+        return;
+    }
+
+    ws2812_pixels[led][0] = (uint8_t)(color >> 8);
+    ws2812_pixels[led][1] = (uint8_t)(color >> 16);
+    ws2812_pixels[led][2] = (uint8_t)color;
+#if WS2812_BPP > 3U
+    ws2812_pixels[led][3] = (uint8_t)(color >> 24);
+#endif
+}
+
+
+uint32_t WS2812_GetPixel(uint16_t led)
+{
+    uint32_t color;
+
+    if (led >= ws2812_count) {
+        return 0U;
+    }
+
+    color = ((uint32_t)ws2812_pixels[led][1] << 16) | ((uint32_t)ws2812_pixels[led][0] << 8)
+          | (uint32_t)ws2812_pixels[led][2];
+#if WS2812_BPP > 3U
+    color |= (uint32_t)ws2812_pixels[led][3] << 24;
+#endif
+
+    return color;
+}
+
+
+void WS2812_Fill(uint32_t color)
+{
+    uint16_t i;
+
+    for (i = 0U; i < ws2812_count; i++) {
+        WS2812_SetPixel(i, color);
+    }
+}
+
+
+void WS2812_Show(void)
+{
+    uint32_t primask;
+    const uint8_t *src = &ws2812_pixels[0][0];
+    const uint8_t *end = src + (uint32_t)ws2812_count * WS2812_BPP;
+    uint8_t *dst;
+    uint32_t code;
+    uint8_t buff;
+
+    /*
+     * A waiting frame is dropped so that the DMA interrupt cannot start the
+     * buffer while it is rewritten
+     */
+    DisableInterruptsSave(primask);
+    ws2812_pending = false;
+    buff = (ws2812_active == 0U) ? 1U : 0U;
+    RestoreInterrupts(primask);
+
+    dst = ws2812_buff[buff];
+    while (src < end) {
+        code = ws2812_exp[*src++];
+        *dst++ = (uint8_t)(code >> 16);
+        *dst++ = (uint8_t)(code >> 8);
+        *dst++ = (uint8_t)code;
+    }
+
+    DisableInterruptsSave(primask);
+    if (ws2812_active == WS2812_IDLE) {
+        ws2812_start(buff);
+    }
+    else {
+        ws2812_pending = true;
+    }
+    RestoreInterrupts(primask);
+}
+
+
+bool WS2812_IsBusy(void)
+{
+    return (ws2812_active != WS2812_IDLE);
+}
+
+
+uint32_t WS2812_GetFrames(void)
+{
+    return ws2812_frames;
+}
+
+
+void Test_WS2812(void)
+{
+    uint32_t start, encode, next;
+    uint32_t worst = 0U;
+    uint16_t i;
+    uint8_t offset = 0U;
+
+    WS2812_Init(300U);
+    LPIT_Init();
+    next = LPIT_GetTimestamp();
+
+    while(1)
+    {
+        for (i = 0U; i < 300U; i++) {
+            WS2812_SetPixel(i, ws2812_wheel((uint8_t)(i + offset)));
+        }
+        offset++;
+
+        start = LPIT_GetTimestamp();
+        WS2812_Show();
+        encode = LPIT_GetTimestamp() - start;
+        worst = (encode > worst) ? encode : worst;
+
+        if ((ws2812_frames % 60U) == 0U) {
+            printf("WS2812 frames %lu encode %lu us (max %lu us)\n", (unsigned long)ws2812_frames,
+                   (unsigned long)(encode / (LPIT_CLK_HZ / 1000000U)),
+                   (unsigned long)(worst / (LPIT_CLK_HZ / 1000000U)));
+        }
+
+        /* 60 fps, the strip is refreshed by the DMA while waiting */
+        next += LPIT_US_TO_TICKS(16667U);
+        while ((int32_t)(LPIT_GetTimestamp() - next) < 0);
+    }
+}
+
+//==============================================================================
+//                       STATIC FUNCTION DEFINITIONS
+//==============================================================================
+/*
+ * @brief: Send a transmit buffer
+ * @param: buff: buffer index
+ * @note: Called with the interrupts disabled
+ */
+static void ws2812_start(uint8_t buff)
+{
+    uint16_t len = (uint16_t)(ws2812_count * WS2812_BYTES_PER_LED + WS2812_RESET_BYTES);
+    dma_tcd tcd = {
+        .saddr = (uint32_t)ws2812_buff[buff],
+        .soff = 1,
+        .attr = DMA_ATTR(DMA_SIZE_8BIT, DMA_SIZE_8BIT),
+        .nbytes = 1U,
+        .slast = 0,
+        .daddr = (uint32_t)&LPSPI1->TDR,
+        .doff = 0,
+        .citer = len,
+        .dlast_sga = 0,
+        .csr = DMA_TCD_CSR_INTMAJOR_MASK | DMA_TCD_CSR_DREQ_MASK,
+        .biter = len,
+    };
+
+    ws2812_active = buff;
+    DMA_TcdLoad(DMA_CH_WS2812, &tcd);
+    DMA_ChannelStart(DMA_CH_WS2812);
+}
+
+
+/*
+ * @brief: End of a frame, start the waiting one
+ * @param: ch: DMA channel
+ * @param: ctx: not used
+ */
+static void ws2812_dma_callback(uint8_t ch, void *ctx)
+{
+    (void)ch;
+    (void)ctx;
+
+    ws2812_frames++;
+
+    if (ws2812_pending) {
+        ws2812_pending = false;
+        ws2812_start((ws2812_active == 0U) ? 1U : 0U);
+    }
+    else {
+        ws2812_active = WS2812_IDLE;
+    }
+}
+
+
+/*
+ * @brief: Select the LPSPI1 clock of an operating point
+ * @param: profile: operating point
+ * @note: SOSCDIV2 and SIRCDIV2 both give 8 MHz, the clock source can only
+ *        change while the clock is gated
+ */
+static void ws2812_clock_select(clock_profile profile)
+{
+    PCC->PCCn[PCC_LPSPI1_INDEX] = 0U;
+    PCC->PCCn[PCC_LPSPI1_INDEX] = PCC_PCCn_PCS((profile == CLOCK_PROFILE_VLPR) ? WS2812_PCS_SIRCDIV2 : WS2812_PCS_SOSCDIV2)
+                                | PCC_PCCn_CGC_MASK;
+}
+
+
+/*
+ * @brief: Finish the frame in flight and move LPSPI1 to the new clock
+ * @note: Called with the interrupts disabled, so the DMA interrupt cannot run:
+ *        the end of the frame is read from the hardware and the interrupt
+ *        runs once the change is done. The last bytes are the zero latch,
+ *        so the clock may stop while they are shifted out.
+ */
+static void ws2812_clock_notifier(clock_event event, clock_profile profile, void *ctx)
+{
+    (void)ctx;
+
+    if (event == CLOCK_PRE_CHANGE) {
+        if (ws2812_active != WS2812_IDLE) {
+            while (DMA->ERQ & (1UL << DMA_CH_WS2812));                 // DREQ clears it
+            while (LPSPI1->FSR & LPSPI_FSR_TXCOUNT_MASK);
+        }
+    }
+    else {
+        ws2812_clock_select(profile);
+    }
+}
+
+
+/*
+ * @brief: Colour wheel for the test routine
+ * @param: pos: position on the wheel
+ * @return: 0x00RRGGBB at 1/4 brightness
+ */
+static uint32_t ws2812_wheel(uint8_t pos)
+{
+    uint8_t a = (uint8_t)((pos % 85U) * 3U / 4U);
+    uint8_t b = (uint8_t)(63U - a);
+
+    if (pos < 85U) {
+        return WS2812_RGB(b, a, 0U);
+    }
+    if (pos < 170U) {
+        return WS2812_RGB(0U, b, a);
+    }
+    return WS2812_RGB(a, 0U, b);
+}
@@ -56,35 +56,11 @@
 //==============================================================================
 //                       PUBLIC FUNCTION DEFINITIONS
 //==============================================================================
-void PORTD_IRQHandler()
-{
-    uint32_t temp = PORTD->ISFR;
-    PORTD->ISFR = 0xFFFFFFFF;
-
-    /* PTD2 */
-    if (temp & (1 << 2)) {
-        LED_Reverse(3);
-    }
-    /* PTD3 */
-    else if (temp & (1 << 3)) {
-        LED_Reverse(6);
-        LED_Reverse(4);
-    }
-    /* PTD4 */
-    else if (temp & (1 << 4)) {
-        LED_Reverse(5);
-    }
-    else {
-        /* Do nothing */
-    }
-}
-
 int main(void)
 {
     DisableInterrupts;
-    SPLL_Init(PLL160);
+    CLOCK_Init(CLOCK_CORE_HZ, CLOCK_BUS_HZ, CLOCK_SLOW_HZ);
     UART_Init(LPUART0, 115200);
-    NormalRUNmode_80MHz();
 
     BUZZ_Init();
     systime.init();
@@ -103,8 +79,11 @@ int main(void)
     BUZZ_playNote('E', 150);
     delay(1000);
 
-    /* Play the song */
-    BUZZ_MainTask();
+    /* Play the song, the notes are sequenced from the timer interrupt */
+    while (1) {
+        BUZZ_MainTask();
+        __asm("WFI");
+    }
 
     return 0;
 }
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+# =============================================================================
+# File Name    : la2vcd.py
+# Project      : S32K144_basic
+# Module       : Logic Analyzer Module (host tool)
+# Author       : JuaBue
+# Created On   : 2026-10-19
+# Version      : 1.0.0
+#
+# Description  :
+#   Converts the text printed by LOGIC_Dump() into a Value Change Dump file
+#   that can be opened with GTKWave or PulseView. Any line before the
+#   "#LOGIC" header (e.g. other printf output of the serial log) is ignored.
+#
+#   Usage: la2vcd.py capture.txt [-o capture.vcd] [--mask 0x1C]
+#
+# License :
+#   This file is part of a free software project released under the terms of
+#   the GNU General Public License version 3 (GPLv3).
+#
+#   Copyright (c) 2025 Juan I. Bueno
+#   All rights reserved.
+#
+# =============================================================================
+import argparse
+import sys
+
+VCD_IDS = [chr(33 + i) for i in range(32)]
+
+
+def parse_dump(lines):
+    """Return (header dict, list of (ticks, port)) from a LOGIC_Dump() log."""
+    header = None
+    samples = []
+    for line in lines:
+        line = line.strip()
+        if line.startswith('#LOGIC'):
+            header = dict(f.split('=', 1) for f in line.split()[1:])
+            samples = []
+        elif line.startswith('#END'):
+            if header is not None:
+                break
+        elif header is not None and line:
+            ticks, port = line.split()
+            samples.append((int(ticks, 16), int(port, 16)))
+    if header is None:
+        raise ValueError('no "#LOGIC" header found')
+    return header, samples
+
+
+def unwrap(samples):
+    """Make the 32-bit time base monotonic and relative to the first sample."""
+    out = []
+    base = 0
+    last = None
+    for ticks, port in samples:
+        if last is not None and ticks < last:
+            base += 1 << 32
+        last = ticks
+        out.append((base + ticks, port))
+    if out:
+        first = out[0][0]
+        out = [(t - first, p) for t, p in out]
+    return out
+
+
+def write_vcd(out, header, samples, mask):
+    port = header.get('port', 'X')
+    clock = int(header['clock'])
+    pins = [n for n in range(32) if mask & (1 << n)]
+
+    out.write('$date S32K144 logic capture $end\n')
+    out.write('$timescale 1 ns $end\n')
+    out.write('$scope module PT%s $end\n' % port)
+    for n in pins:
+        out.write('$var wire 1 %s PT%s%d $end\n' % (VCD_IDS[n], port, n))
+    out.write('$upscope $end\n$enddefinitions $end\n')
+
+    previous = None
+    for ticks, value in samples:
+        changed = [n for n in pins
+                   if previous is None or ((value ^ previous) >> n) & 1]
+        if not changed:
+            continue
+        out.write('#%d\n' % (ticks * 1000000000 // clock))
+        for n in changed:
+            out.write('%d%s\n' % ((value >> n) & 1, VCD_IDS[n]))
+        previous = value
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert LOGIC_Dump() output to VCD')
+    parser.add_argument('input', help='serial log containing LOGIC_Dump() output')
+    parser.add_argument('-o', '--output', help='VCD file (default: stdout)')
+    parser.add_argument('--mask', help='pins to export (default: mask of the dump)')
+    args = parser.parse_args()
+
+    with open(args.input, 'r') as f:
+        header, samples = parse_dump(f)
+
+    mask = int(args.mask, 0) if args.mask else int(header.get('mask', 'ffffffff'), 16)
+    if mask == 0:
+        mask = 0xFFFFFFFF
+
+    out = open(args.output, 'w') if args.output else sys.stdout
+    try:
+        write_vcd(out, header, unwrap(samples), mask)
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+
+if __name__ == '__main__':
+    main()
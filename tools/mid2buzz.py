@@ -0,0 +1,320 @@
+#!/usr/bin/env python3
+# =============================================================================
+# File Name    : mid2buzz.py
+# Project      : S32K144_basic
+# Module       : Buzz Module (host tool)
+# Author       : JuaBue
+# Created On   : 2026-10-19
+# Version      : 1.0.0
+#
+# Description  :
+#   Compiles a standard MIDI file (format 0 or 1) into a table of packed
+#   buzz_note words for BUZZ_Play(). The buzzer plays one note at a time, so
+#   the selected tracks are merged and the highest sounding note is kept.
+#   Note boundaries are quantized to the BUZZ_TICK_MS grid using the tempo
+#   map of the file, which keeps the song length exact.
+#
+#   The output only depends on the input file and the options, so songs can
+#   be regenerated as part of the build. The header checks BUZZ_TICK_MS with
+#   #error, so a tempo change in BUZZ.h cannot silently stretch the song.
+#
+#   Usage: mid2buzz.py song.mid [-o song.h] [--name song_x] [--track 1]
+#                      [--transpose 12] [--fold] [--tick-ms 31] [--gap-ms 2000]
+#
+# License :
+#   This file is part of a free software project released under the terms of
+#   the GNU General Public License version 3 (GPLv3).
+#
+#   Copyright (c) 2025 Juan I. Bueno
+#   All rights reserved.
+#
+# =============================================================================
+import argparse
+import os
+import re
+import struct
+import sys
+
+MIDI_MIN = 48                   # BUZZ_MIDI_MIN, C3
+MIDI_MAX = 110                  # BUZZ_MIDI_MAX, D8
+TICKS_MAX = 0x3FF               # Duration field of a packed note
+DRUM_CHANNEL = 9                # MIDI channel 10
+NAMES = ['C', 'C#', 'D', 'D#', 'E', 'F', 'F#', 'G', 'G#', 'A', 'A#', 'B']
+
+
+def note_name(m):
+    return '%s%d' % (NAMES[m % 12], m // 12 - 1)
+
+
+def read_varlen(data, pos):
+    value = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value = (value << 7) | (byte & 0x7F)
+        if not byte & 0x80:
+            return value, pos
+
+
+def parse_track(data):
+    """Return a list of (tick, kind, channel, a, b) for notes and tempo."""
+    events = []
+    pos = 0
+    tick = 0
+    status = None
+    while pos < len(data):
+        delta, pos = read_varlen(data, pos)
+        tick += delta
+        if data[pos] & 0x80:
+            status = data[pos]
+            pos += 1
+        elif status is None:
+            raise ValueError('running status without a status byte')
+
+        if status == 0xFF:
+            kind = data[pos]
+            length, pos = read_varlen(data, pos + 1)
+            if kind == 0x51 and length == 3:
+                events.append((tick, 'tempo', 0, int.from_bytes(data[pos:pos + 3], 'big'), 0))
+            elif kind == 0x2F:
+                break
+            pos += length
+            status = None
+        elif status in (0xF0, 0xF7):
+            length, pos = read_varlen(data, pos)
+            pos += length
+            status = None
+        else:
+            kind = status & 0xF0
+            channel = status & 0x0F
+            if kind in (0xC0, 0xD0):
+                pos += 1
+                continue
+            a, b = data[pos], data[pos + 1]
+            pos += 2
+            if kind == 0x90 and b > 0:
+                events.append((tick, 'on', channel, a, b))
+            elif kind == 0x80 or kind == 0x90:
+                events.append((tick, 'off', channel, a, 0))
+    return events
+
+
+def parse_midi(data):
+    """Return (division, list of tracks) of a standard MIDI file."""
+    if data[:4] != b'MThd':
+        raise ValueError('not a standard MIDI file')
+    length, fmt, ntrks, division = struct.unpack('>IHHH', data[4:14])
+    if fmt > 1:
+        raise ValueError('MIDI format %d is not supported' % fmt)
+    if division & 0x8000:
+        raise ValueError('SMPTE time division is not supported')
+
+    tracks = []
+    pos = 8 + length
+    while pos + 8 <= len(data) and len(tracks) < ntrks:
+        chunk, size = struct.unpack('>4sI', data[pos:pos + 8])
+        if chunk == b'MTrk':
+            tracks.append(parse_track(data[pos + 8:pos + 8 + size]))
+        pos += 8 + size
+    return division, tracks
+
+
+def tempo_map(tracks, division):
+    """Return a function converting MIDI ticks to ms with the tempo changes."""
+    changes = sorted((e[0], e[3]) for t in tracks for e in t if e[1] == 'tempo')
+    points = [(0, 0.0, 500000)]                     # 120 bpm until the first change
+    for tick, usec in changes:
+        last_tick, last_ms, last_usec = points[-1]
+        ms = last_ms + (tick - last_tick) * last_usec / (division * 1000.0)
+        if tick == last_tick:
+            points[-1] = (tick, last_ms, usec)
+        else:
+            points.append((tick, ms, usec))
+
+    def to_ms(tick):
+        for p in reversed(points):
+            if tick >= p[0]:
+                return p[1] + (tick - p[0]) * p[2] / (division * 1000.0)
+        return 0.0
+    return to_ms, [p[2] for p in points]
+
+
+def notes_of(tracks, selected, drums):
+    """Return the (start, end, pitch) intervals of the selected tracks."""
+    notes = []
+    for index, events in enumerate(tracks):
+        if selected and index not in selected:
+            continue
+        active = {}
+        for tick, kind, channel, pitch, _ in events:
+            if channel == DRUM_CHANNEL and not drums:
+                continue
+            key = (channel, pitch)
+            if kind == 'on':
+                active.setdefault(key, []).append(tick)
+            elif kind == 'off' and active.get(key):
+                start = active[key].pop(0)
+                if tick > start:
+                    notes.append((start, tick, pitch))
+    return sorted(notes)
+
+
+def skyline(notes):
+    """Merge overlapping notes into (start, end, pitch or None) segments."""
+    times = sorted({t for n in notes for t in n[:2]})
+    segments = []
+    for t0, t1 in zip(times, times[1:]):
+        sounding = [n[2] for n in notes if n[0] <= t0 and n[1] >= t1]
+        pitch = max(sounding) if sounding else None
+        # A repeated key starts a new note, a held one extends the segment
+        restrike = any(n[0] == t0 and n[2] == pitch for n in notes)
+        if segments and segments[-1][2] == pitch and not restrike:
+            segments[-1] = (segments[-1][0], t1, pitch)
+        else:
+            segments.append((t0, t1, pitch))
+    return segments
+
+
+def fit_range(pitch, transpose, fold):
+    pitch += transpose
+    if fold:
+        while pitch < MIDI_MIN:
+            pitch += 12
+        while pitch > MIDI_MAX:
+            pitch -= 12
+    return pitch
+
+
+def compile_song(segments, to_ms, args):
+    """Return (list of (pitch or None, ticks), report dict)."""
+    words = []
+    dropped = 0
+    worst = 0.0
+    out_of_range = set()
+
+    for t0, t1, pitch in segments:
+        if pitch is not None:
+            pitch = fit_range(pitch, args.transpose, args.fold)
+            if not MIDI_MIN <= pitch <= MIDI_MAX:
+                out_of_range.add(pitch)
+        # Quantize the boundaries, not the durations, so errors do not add up
+        q0 = int(to_ms(t0) / args.tick_ms + 0.5)
+        q1 = int(to_ms(t1) / args.tick_ms + 0.5)
+        worst = max(worst, abs(q1 * args.tick_ms - to_ms(t1)))
+        ticks = q1 - q0
+        if ticks == 0:
+            dropped += pitch is not None
+            continue
+        if pitch is None and words and words[-1][0] is None:
+            words[-1] = (None, words[-1][1] + ticks)
+        else:
+            words.append((pitch, ticks))
+
+    # The song starts on its first note
+    while words and words[0][0] is None:
+        words.pop(0)
+    if args.gap_ms:
+        words.append((None, max(1, int(args.gap_ms / args.tick_ms + 0.5))))
+
+    if out_of_range:
+        raise ValueError('notes %s are out of the buzzer range %s..%s, use --transpose or --fold'
+                         % (', '.join(note_name(p) for p in sorted(out_of_range)),
+                            note_name(MIDI_MIN), note_name(MIDI_MAX)))
+
+    report = {'dropped': dropped, 'worst_ms': worst,
+              'ticks': sum(w[1] for w in words)}
+    return words, report
+
+
+def split_long(words):
+    """Split durations that do not fit in the 10-bit field."""
+    out = []
+    for pitch, ticks in words:
+        while ticks > TICKS_MAX:
+            out.append((pitch, TICKS_MAX))
+            ticks -= TICKS_MAX
+        out.append((pitch, ticks))
+    return out
+
+
+def write_header(out, words, name, args, source, report):
+    guard = re.sub(r'\W', '_', name).upper() + '_H_'
+    seconds = report['ticks'] * args.tick_ms / 1000.0
+
+    out.write('/*\n * Generated by tools/mid2buzz.py from %s, do not edit.\n' % source)
+    out.write(' * Options: --tick-ms %d --transpose %d%s%s%s\n'
+              % (args.tick_ms, args.transpose, ' --fold' if args.fold else '',
+                 ''.join(' --track %d' % t for t in args.track or []),
+                 ' --gap-ms %d' % args.gap_ms if args.gap_ms else ''))
+    out.write(' * %d notes, %.1f s\n */\n' % (len(words), seconds))
+    out.write('#ifndef %s\n#define %s\n\n#include "BUZZ.h"\n\n' % (guard, guard))
+    out.write('#if BUZZ_TICK_MS != %dU\n' % args.tick_ms)
+    out.write('#error "%s was generated for BUZZ_TICK_MS %d, run mid2buzz.py again"\n' % (name, args.tick_ms))
+    out.write('#endif\n\n')
+    out.write('static const buzz_note %s[] = {\n' % name)
+    for i in range(0, len(words), 4):
+        line = []
+        for pitch, ticks in words[i:i + 4]:
+            note = 'D0' if pitch is None else 'BUZZ_MIDI(%dU)' % pitch
+            line.append('BUZZ_NOTE(%s, %dU)' % (note, ticks))
+        out.write('    %s,\n' % ', '.join(line))
+    out.write('    BUZZ_END\n};\n\n#endif /* %s */\n' % guard)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile a MIDI file into a BUZZ_Play() table')
+    parser.add_argument('input', help='standard MIDI file')
+    parser.add_argument('-o', '--output', help='C header (default: stdout)')
+    parser.add_argument('--name', help='table name (default: song_<file name>)')
+    parser.add_argument('--track', type=int, action='append',
+                        help='track to use, can be repeated (default: all)')
+    parser.add_argument('--drums', action='store_true', help='keep MIDI channel 10')
+    parser.add_argument('--transpose', type=int, default=0, help='semitones added to every note')
+    parser.add_argument('--fold', action='store_true', help='move out of range notes by octaves')
+    parser.add_argument('--tick-ms', type=int, default=31,
+                        help='BUZZ_TICK_MS of the firmware (default: 31)')
+    parser.add_argument('--gap-ms', type=int, default=0, help='rest added at the end')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        division, tracks = parse_midi(f.read())
+
+    if args.track:
+        for t in args.track:
+            if not 0 <= t < len(tracks):
+                parser.error('track %d does not exist, the file has %d' % (t, len(tracks)))
+    to_ms, tempos = tempo_map(tracks, division)
+
+    # Tempo check: the shortest note must last at least one tick
+    notes = notes_of(tracks, set(args.track or []), args.drums)
+    if not notes:
+        parser.error('no notes in the selected tracks')
+    shortest = min(to_ms(n[1]) - to_ms(n[0]) for n in notes)
+    if shortest < args.tick_ms / 2.0:
+        sys.stderr.write('warning: shortest note %.1f ms is under half a tick (%d ms), '
+                         'fast notes will be dropped\n' % (shortest, args.tick_ms))
+
+    base = os.path.splitext(os.path.basename(args.input))[0]
+    name = args.name or 'song_' + re.sub(r'\W', '_', base).lower()
+    try:
+        words, report = compile_song(skyline(notes), to_ms, args)
+    except ValueError as e:
+        sys.exit('error: %s' % e)
+    words = split_long(words)
+
+    sys.stderr.write('%s: %d notes, %.1f s, %d tempo(s) %s bpm, quantization error <= %.1f ms'
+                     ', %d dropped\n'
+                     % (name, len(words), report['ticks'] * args.tick_ms / 1000.0, len(tempos),
+                        '/'.join('%.0f' % (60000000.0 / t) for t in tempos),
+                        report['worst_ms'], report['dropped']))
+
+    out = open(args.output, 'w') if args.output else sys.stdout
+    try:
+        write_header(out, words, name, args, os.path.basename(args.input), report)
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+
+if __name__ == '__main__':
+    main()